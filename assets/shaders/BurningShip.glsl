@@ -1,26 +1,26 @@
-float fractalFunction(in dvec2 c)
+real fractalFunction(in real2 c)
 {
-    double n = 0.0;
-    dvec2 z = dvec2(0.0, 0.0);
+    real n = 0.0;
+    real2 z = real2(0.0, 0.0);
 
     for (int i = 0; i < maxIterations; i++) {
-        double zx = abs(z.x);
-        double zy = abs(z.y);
-        z = dvec2(zx*zx - zy*zy, 2.0*zx*zy) + c;
+        real zx = abs(z.x);
+        real zy = abs(z.y);
+        z = real2(zx*zx - zy*zy, 2.0*zx*zy) + c;
 
-        if (dot(z, z) > (escapeRadius * escapeRadius))
+        if (dot(z, z) > escapeRadiusSq)
             break;
 
         n += 1.0;
     }
 
-    if (n >= double(maxIterations))
+    if (n >= real(maxIterations))
         return 0.0;
 
     if (useSmoothing) {
-        double smooth_val = log2_d(log2_d(dot(z, z)));
-        return float(n - smooth_val + 4.0);
+        real smooth_val = log2_r(log2_r(dot(z, z)));
+        return n - smooth_val + 4.0;
     }
 
-    return float(n);
+    return n;
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+#version 430
+
+#extension GL_ARB_gpu_shader_fp64 : enable
+
+// Maps the iteration buffer written by MainShader through the palette. It is cheap next to the escape-time pass, so
+// palette and frequency edits only rerun this shader.
+
+layout (local_size_x = 16, local_size_y = 16) in;
+layout (r32f, binding = 0) uniform readonly image2D iterationImage;
+layout (rgba8, binding = 1) uniform writeonly image2D destImage;
+
+uniform double paletteFrequency;
+
+// The palette baked at evenly spaced positions; entry i is the color at i / (size - 1).
+layout (binding = 0) uniform sampler1D paletteLut;
+
+// Maps t in [0, 1] onto the texel centers, so t = 0 and t = 1 hit the end stops exactly. Compute shaders have no
+// derivatives, hence the explicit level.
+vec3 getPaletteColor(float t) {
+    float size = float(textureSize(paletteLut, 0));
+    return textureLod(paletteLut, (clamp(t, 0.0, 1.0) * (size - 1.0) + 0.5) / size, 0.0).rgb;
+}
+
+void main()
+{
+    ivec2 pixelCoord = ivec2(gl_GlobalInvocationID.xy);
+
+    if (any(greaterThanEqual(pixelCoord, imageSize(destImage))))
+        return;
+
+    double iter = double(imageLoad(iterationImage, pixelCoord).r);
+
+    vec3 finalColor = vec3(0.0);
+
+    if (iter > 0.0)
+    {
+        double v = iter * paletteFrequency;
+
+        double t_double = (mod(floor(v), 2.0) == 0.0) ? fract(v) : 1.0 - fract(v);
+        
+        float t_float = float(t_double);
+        
+        finalColor = getPaletteColor(t_float);
+    }
+
+    imageStore(destImage, pixelCoord, vec4(finalColor, 1.0));
+}
+
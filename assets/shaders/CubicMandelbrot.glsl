@@ -1,24 +1,49 @@
-float fractalFunction(in vec2 c)
+real fractalFunction(in real2 c)
 {
-    float n = 0.0;
-    vec2 z = vec2(0.0);
+    real n = 0.0;
+    real2 z = real2(0.0);
+    CycleDetector cycles = startCycleDetection(z);
     for (int i = 0; i < maxIterations; i++) {
-        float zx_squared = z.x * z.x;
-        float zy_squared = z.y * z.y;
+        real zx_squared = z.x * z.x;
+        real zy_squared = z.y * z.y;
 
-        float next_zx = z.x * zx_squared - 3.0 * z.x * zy_squared;
-        float next_zy = 3.0 * zx_squared * z.y - z.y * zy_squared;
+        real next_zx = z.x * zx_squared - 3.0 * z.x * zy_squared;
+        real next_zy = 3.0 * zx_squared * z.y - z.y * zy_squared;
 
-        z = vec2(next_zx, next_zy) + c;
+        z = real2(next_zx, next_zy) + c;
 
-        if (dot(z, z) > (escapeRadius * escapeRadius))
+        if (dot(z, z) > escapeRadiusSq)
             break;
         n += 1.0;
+        if (orbitCycled(cycles, z)) {
+            n = real(maxIterations);
+            break;
+        }
     }
 
-    if (n >= float(maxIterations))
+    if (n >= real(maxIterations))
         return 0.0;
 
-    float smoothCount = n - log2(log2(dot(z, z))) + 4.0;
+    real smoothCount = n - log2_r(log2_r(dot(z, z))) + 4.0;
     return smoothCount;
-}
\ No newline at end of file
+}
+
+#ifdef FRACTAL_DOUBLE_DOUBLE
+double fractalFunctionDD(in dvec4 c)
+{
+    double n = 0.0;
+    dvec4 z = dvec4(0.0);
+    for (int i = 0; i < maxIterations; i++) {
+        z = ddcAdd(ddcMul(ddcSqr(z), z), c);
+
+        if (ddcNormSq(z) > (escapeRadius * escapeRadius))
+            break;
+        n += 1.0;
+    }
+
+    if (n >= double(maxIterations))
+        return 0.0;
+
+    return n - log2_d(log2_d(ddcNormSq(z))) + 4.0;
+}
+#endif
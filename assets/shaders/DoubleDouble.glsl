@@ -0,0 +1,113 @@
+#ifndef DOUBLE_DOUBLE_GLSL
+#define DOUBLE_DOUBLE_GLSL
+
+// Double-double arithmetic: a real is the unevaluated sum hi + lo of two doubles, stored as dvec2(hi, lo), for
+// about 106 bits of mantissa. A complex number is dvec4(re.hi, re.lo, im.hi, im.lo). Every error term relies on
+// exact IEEE rounding, so intermediates are `precise` to keep the compiler from fusing or reassociating them.
+
+// Low half of the view center, so that offset + offsetLow carries the center to double-double precision.
+uniform dvec2 offsetLow;
+
+dvec2 ddTwoSum(double a, double b)
+{
+    precise double s = a + b;
+    precise double bb = s - a;
+    precise double e = (a - (s - bb)) + (b - bb);
+    return dvec2(s, e);
+}
+
+// Requires |a| >= |b|.
+dvec2 ddQuickTwoSum(double a, double b)
+{
+    precise double s = a + b;
+    precise double e = b - (s - a);
+    return dvec2(s, e);
+}
+
+dvec2 ddTwoProd(double a, double b)
+{
+    precise double p = a * b;
+    precise double e = fma(a, b, -p);
+    return dvec2(p, e);
+}
+
+dvec2 ddAdd(dvec2 a, dvec2 b)
+{
+    precise dvec2 s = ddTwoSum(a.x, b.x);
+    precise dvec2 t = ddTwoSum(a.y, b.y);
+    s.y += t.x;
+    s = ddQuickTwoSum(s.x, s.y);
+    s.y += t.y;
+    return ddQuickTwoSum(s.x, s.y);
+}
+
+dvec2 ddSub(dvec2 a, dvec2 b)
+{
+    return ddAdd(a, -b);
+}
+
+dvec2 ddMul(dvec2 a, dvec2 b)
+{
+    precise dvec2 p = ddTwoProd(a.x, b.x);
+    p.y += a.x * b.y + a.y * b.x;
+    return ddQuickTwoSum(p.x, p.y);
+}
+
+dvec2 ddMulDouble(dvec2 a, double b)
+{
+    precise dvec2 p = ddTwoProd(a.x, b);
+    p.y += a.y * b;
+    return ddQuickTwoSum(p.x, p.y);
+}
+
+dvec2 ddSqr(dvec2 a)
+{
+    precise dvec2 p = ddTwoProd(a.x, a.x);
+    p.y += 2.0 * a.x * a.y;
+    return ddQuickTwoSum(p.x, p.y);
+}
+
+dvec2 ddDiv(dvec2 a, dvec2 b)
+{
+    precise double q1 = a.x / b.x;
+    precise dvec2 r = ddSub(a, ddMulDouble(b, q1));
+    precise double q2 = r.x / b.x;
+    return ddQuickTwoSum(q1, q2);
+}
+
+dvec4 ddcAdd(dvec4 a, dvec4 b)
+{
+    return dvec4(ddAdd(a.xy, b.xy), ddAdd(a.zw, b.zw));
+}
+
+dvec4 ddcSub(dvec4 a, dvec4 b)
+{
+    return dvec4(ddSub(a.xy, b.xy), ddSub(a.zw, b.zw));
+}
+
+dvec4 ddcMul(dvec4 a, dvec4 b)
+{
+    return dvec4(ddSub(ddMul(a.xy, b.xy), ddMul(a.zw, b.zw)), ddAdd(ddMul(a.xy, b.zw), ddMul(a.zw, b.xy)));
+}
+
+dvec4 ddcSqr(dvec4 z)
+{
+    return dvec4(ddSub(ddSqr(z.xy), ddSqr(z.zw)), ddMulDouble(ddMul(z.xy, z.zw), 2.0));
+}
+
+// |z|^2 to double precision, which is all escape and convergence tests need.
+double ddcNormSq(dvec4 z)
+{
+    return z.x * z.x + z.z * z.z;
+}
+
+dvec4 pixelToComplexDD(in ivec2 pixelCoord)
+{
+    dvec2 delta = pixelDelta(pixelCoord);
+    return dvec4(ddAdd(dvec2(offset.x, offsetLow.x), dvec2(delta.x, 0.0)),
+                 ddAdd(dvec2(offset.y, offsetLow.y), dvec2(delta.y, 0.0)));
+}
+
+double fractalFunctionDD(in dvec4 c);
+
+#endif
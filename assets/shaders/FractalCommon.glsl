@@ -1,42 +1,57 @@
 #ifndef FRACTAL_COMMON_GLSL
 #define FRACTAL_COMMON_GLSL
 
-#define MAX_PALETTE_STOPS 16
+// Scalar type of the escape-time loops. FRACTAL_SINGLE_PRECISION runs them in fp32 for shallow views, where fp64
+// only costs throughput; view uniforms and pixel mapping stay in double either way.
+#ifdef FRACTAL_SINGLE_PRECISION
+#define real float
+#define real2 vec2
+#else
+#define real double
+#define real2 dvec2
+#endif
+
+// Kernel shape KernelTuner picked for this fractal: the workgroup size, and the samples each invocation takes, in a
+// SAMPLES_X x SAMPLES_Y grid of workgroup-sized steps.
+#ifndef WORK_GROUP_WIDTH
+#define WORK_GROUP_WIDTH 16
+#define WORK_GROUP_HEIGHT 16
+#endif
+#ifndef SAMPLES_X
+#define SAMPLES_X 1
+#define SAMPLES_Y 1
+#endif
 
-layout (local_size_x = 16, local_size_y = 16) in;
-layout (rgba8, binding = 0) uniform writeonly image2D destImage;
+layout (local_size_x = WORK_GROUP_WIDTH, local_size_y = WORK_GROUP_HEIGHT) in;
+layout (r32f, binding = 0) uniform writeonly image2D iterationImage;
 
 uniform dvec2 fullResolution;
 uniform dvec2 offset;
 uniform double zoom;
 uniform int maxIterations;
 uniform bool useSmoothing;
-uniform double paletteFrequency;
 
 #if defined(FRACTAL_JULIA)
 uniform dvec2 juliaC;
 #endif
 
-struct ColorStop {
-    vec3 color;
-    float position;
-};
-
-layout(std140, binding = 0) uniform Palette {
-    int numStops;
-    ColorStop stops[MAX_PALETTE_STOPS];
-} paletteData;
-
 const double escapeRadius = 4.0;
+const real escapeRadiusSq = real(escapeRadius * escapeRadius);
 
-dvec2 pixelToComplex(in ivec2 pixelCoord)
+// Offset of a pixel from the view center in the complex plane.
+dvec2 pixelDelta(in ivec2 pixelCoord)
 {
     dvec2 uv = dvec2(
         (double(pixelCoord.x) / fullResolution.x) - 0.5,
         0.5 - (double(pixelCoord.y) / fullResolution.y)
     );
     uv.x *= fullResolution.x / fullResolution.y;
-    return offset + uv / zoom;
+    return uv / zoom;
+}
+
+dvec2 pixelToComplex(in ivec2 pixelCoord)
+{
+    return offset + pixelDelta(pixelCoord);
 }
 
 const double LN2_D = 0.693147180559945309417;
@@ -65,6 +80,44 @@ double log2_d(double x) {
     return log_d(x) / LN2_D;
 }
 
-double fractalFunction(in dvec2 c);
+#ifdef FRACTAL_SINGLE_PRECISION
+float log2_r(float x) { return log2(x); }
+#else
+double log2_r(double x) { return log2_d(x); }
+#endif
+
+// Brent-style cycle detection: an orbit that returns to within a small fraction of a pixel of a point saved at a
+// power-of-two iteration is caught in an attracting cycle, so the pixel is interior and can stop iterating.
+const double CYCLE_TOLERANCE_PIXELS = 1.0 / 1024.0;
+
+struct CycleDetector {
+    real2 saved;
+    int sinceSaved;
+    int saveInterval;
+    real toleranceSq;
+};
+
+CycleDetector startCycleDetection(real2 z0)
+{
+    real tolerance = real(CYCLE_TOLERANCE_PIXELS / (zoom * fullResolution.y));
+    return CycleDetector(z0, 0, 1, tolerance * tolerance);
+}
+
+// Call once per iteration after the escape test.
+bool orbitCycled(inout CycleDetector detector, real2 z)
+{
+    real2 d = z - detector.saved;
+    if (dot(d, d) < detector.toleranceSq)
+        return true;
+
+    if (++detector.sinceSaved == detector.saveInterval) {
+        detector.saved = z;
+        detector.sinceSaved = 0;
+        detector.saveInterval *= 2;
+    }
+    return false;
+}
+
+real fractalFunction(in real2 c);
 
 #endif
\ No newline at end of file
@@ -1,17 +1,41 @@
-float fractalFunction(in vec2 z)
+real fractalFunction(in real2 z)
 {
-    float n = 0.0;
+    real n = 0.0;
+    CycleDetector cycles = startCycleDetection(z);
     for (int i = 0; i < maxIterations; i++) {
         // Julia iteration: z = z^2 + juliaC
-        z = vec2(z.x * z.x - z.y * z.y, 2.0 * z.x * z.y) + juliaC;
-        if (dot(z, z) > (escapeRadius * escapeRadius))
+        z = real2(z.x * z.x - z.y * z.y, 2.0 * z.x * z.y) + real2(juliaC);
+        if (dot(z, z) > escapeRadiusSq)
             break;
         n += 1.0;
+        if (orbitCycled(cycles, z)) {
+            n = real(maxIterations);
+            break;
+        }
     }
     
-    if (n >= float(maxIterations))
+    if (n >= real(maxIterations))
         return 0.0;
     
-    float smoothCount = n - log2(log2(dot(z, z))) + 4.0;
+    real smoothCount = n - log2_r(log2_r(dot(z, z))) + 4.0;
     return smoothCount;
 }
+
+#ifdef FRACTAL_DOUBLE_DOUBLE
+double fractalFunctionDD(in dvec4 z)
+{
+    dvec4 c = dvec4(juliaC.x, 0.0, juliaC.y, 0.0);
+    double n = 0.0;
+    for (int i = 0; i < maxIterations; i++) {
+        z = ddcAdd(ddcSqr(z), c);
+        if (ddcNormSq(z) > (escapeRadius * escapeRadius))
+            break;
+        n += 1.0;
+    }
+
+    if (n >= double(maxIterations))
+        return 0.0;
+
+    return n - log2_d(log2_d(ddcNormSq(z))) + 4.0;
+}
+#endif
@@ -4,6 +4,10 @@
 
 #include "FractalCommon.glsl"
 
+#ifdef FRACTAL_DOUBLE_DOUBLE
+#include "DoubleDouble.glsl"
+#endif
+
 #ifdef FRACTAL_MANDELBROT
 #include "Mandelbrot.glsl"
 #elif defined(FRACTAL_JULIA)
@@ -20,62 +24,123 @@
 #error "No fractal algorithm defined"
 #endif
 
-// This palette function linearly interpolates between the color stops
-// provided in the Palette UBO.
-vec3 getPaletteColor(float t) {
-    if (paletteData.numStops == 0) return vec3(0.0);
-    if (t <= paletteData.stops[0].position) return paletteData.stops[0].color;
-    if (t >= paletteData.stops[paletteData.numStops - 1].position) return paletteData.stops[paletteData.numStops - 1].color;
-
-    for (int i = 0; i < paletteData.numStops - 1; i++) {
-        ColorStop current = paletteData.stops[i];
-        ColorStop next = paletteData.stops[i+1];
-        if (t >= current.position && t <= next.position) {
-            float range = next.position - current.position;
-            float segmentT = (range < 1e-6) ? 0.0 : (t - current.position) / range;
-            return mix(current.color, next.color, segmentT);
-        }
-    }
-    return paletteData.stops[paletteData.numStops - 1].color;
-}
+#ifdef FRACTAL_PERTURBATION
+#include "Perturbation.glsl"
+#endif
 
+// A dispatch covers the pixels in [regionOrigin, regionEnd), which is the whole image except when filling the
+// strips a pan exposed. Progressive refinement: each invocation samples the top-left pixel of a
+// sampleStride x sampleStride block and paints the whole block with it. When refining a pass of twice the
+// stride, blocks whose sample that pass already took are left as they are.
+uniform ivec2 regionOrigin;
+uniform ivec2 regionEnd;
+uniform int sampleStride;
+uniform bool refinesCoarserPass;
+
+// Persistent threads: instead of one workgroup per tile, a fixed number of workgroups take tiles off a queue until
+// it runs dry, so the few slow tiles along the set boundary no longer hold up a mostly idle GPU at the end of the
+// dispatch. TileQueue lists the tiles most expensive first, and each workgroup records the iterations its tile took
+// for the next frame's order; costLevelColumns is 0 when the target keeps no costs.
+layout (std430, binding = 3) buffer TileQueue
+{
+    uint nextTile;
+    uint tileOrder[];
+};
 
-void main()
+layout (std430, binding = 4) buffer TileCosts
 {
-    ivec2 pixelCoord = ivec2(gl_GlobalInvocationID.xy);
+    float tileCosts[];
+};
 
-    if (pixelCoord.x >= int(fullResolution.x) || pixelCoord.y >= int(fullResolution.y))
-        return;
+uniform bool persistentThreads;
+uniform int tileColumns;
+uniform int tileCount;
+uniform int costLevelOffset;
+uniform int costLevelColumns;
+
+shared uint currentTile;
+shared uint tileIterations;
+
+// Renders one sample and returns roughly the iterations it took, 0 when it was skipped.
+uint renderSample(ivec2 pixelCoord)
+{
+    if (pixelCoord.x >= regionEnd.x || pixelCoord.y >= regionEnd.y)
+        return 0u;
 
+    if (refinesCoarserPass && all(equal(pixelCoord % (2 * sampleStride), ivec2(0))))
+        return 0u;
+
+#ifdef FRACTAL_PERTURBATION
+    double iter = perturbedFractalFunction(pixelDelta(pixelCoord));
+#elif defined(FRACTAL_DOUBLE_DOUBLE)
+    double iter = fractalFunctionDD(pixelToComplexDD(pixelCoord));
+#else
     dvec2 coord = pixelToComplex(pixelCoord);
     
-    double iter = fractalFunction(coord); 
+    double iter = fractalFunction(real2(coord));
+#endif
 
-    vec3 finalColor = vec3(0.0);
+    ivec2 blockEnd = min(pixelCoord + sampleStride, regionEnd);
+    for (int y = pixelCoord.y; y < blockEnd.y; y++)
+        for (int x = pixelCoord.x; x < blockEnd.x; x++)
+            imageStore(iterationImage, ivec2(x, y), vec4(float(iter)));
 
-    if (iter > 0.0)
-    {
-        double v = iter * paletteFrequency;
+    // Points that never escape come back as 0. They count as the whole iteration budget, which overrates the ones the
+    // cardioid test or cycle detection let off early, but keeps the interior ahead of the cheap exterior.
+    return iter > 0.0 ? uint(iter) : uint(maxIterations);
+}
 
-        double t_double = (mod(floor(v), 2.0) == 0.0) ? fract(v) : 1.0 - fract(v);
-        
-        float t_float = float(t_double);
-        
-        finalColor = getPaletteColor(t_float);
-    }
+const ivec2 GROUP_SIZE = ivec2(WORK_GROUP_WIDTH, WORK_GROUP_HEIGHT);
+// Samples one workgroup covers, a tile of the fixed grid and of the queue alike.
+const ivec2 TILE_SAMPLES = GROUP_SIZE * ivec2(SAMPLES_X, SAMPLES_Y);
 
-    imageStore(destImage, pixelCoord, vec4(finalColor, 1.0));
+// Renders this invocation's samples of the tile at tileOrigin, one workgroup-sized step apart so neighbouring
+// invocations keep sampling neighbouring pixels, and returns the iterations they took.
+uint renderTile(ivec2 tileOrigin)
+{
+    uint iterations = 0u;
+    for (int j = 0; j < SAMPLES_Y; j++)
+        for (int i = 0; i < SAMPLES_X; i++)
+        {
+            ivec2 sampleIndex = ivec2(gl_LocalInvocationID.xy) + ivec2(i, j) * GROUP_SIZE;
+            iterations += renderSample(tileOrigin + sampleIndex * sampleStride);
+        }
+    return iterations;
 }
 
-/*
-if (iter > 0.0)
+void main()
 {
-    float v = iter * paletteFrequency;
-
-    // Use a sine wave for smooth, cyclical color
-    // The 0.5 * ... + 0.5 maps the [-1, 1] range of sin() to [0, 1]
-    float t = 0.5 * sin(v * 2.0 * 3.14159265) + 0.5;
+    if (!persistentThreads)
+    {
+        renderTile(regionOrigin + ivec2(gl_WorkGroupID.xy) * TILE_SAMPLES * sampleStride);
+        return;
+    }
 
-    finalColor = getPaletteColor(t);
+    ivec2 tilePixels = TILE_SAMPLES * sampleStride;
+    while (true)
+    {
+        if (gl_LocalInvocationIndex == 0u)
+        {
+            currentTile = atomicAdd(nextTile, 1u);
+            tileIterations = 0u;
+        }
+        memoryBarrierShared();
+        barrier();
+
+        uint queued = currentTile;
+        if (queued >= uint(tileCount))
+            return;
+
+        int tile = int(tileOrder[queued]);
+        ivec2 tileOrigin = regionOrigin + ivec2(tile % tileColumns, tile / tileColumns) * tilePixels;
+        atomicAdd(tileIterations, renderTile(tileOrigin));
+        memoryBarrierShared();
+        barrier();
+
+        if (gl_LocalInvocationIndex == 0u && costLevelColumns > 0)
+        {
+            ivec2 cell = tileOrigin / tilePixels;
+            tileCosts[costLevelOffset + cell.y * costLevelColumns + cell.x] = float(tileIterations);
+        }
+    }
 }
-*/
\ No newline at end of file
@@ -1,39 +1,39 @@
-vec2 complexSub(vec2 a, vec2 b) { return a - b; }
-vec2 complexMul(vec2 a, vec2 b) {
-    return vec2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+real2 complexSub(real2 a, real2 b) { return a - b; }
+real2 complexMul(real2 a, real2 b) {
+    return real2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
 }
-vec2 complexDiv(vec2 a, vec2 b) {
-    float den = dot(b, b); 
-    if (den == 0.0) return vec2(0.0); 
-    return vec2(
+real2 complexDiv(real2 a, real2 b) {
+    real den = dot(b, b); 
+    if (den == 0.0) return real2(0.0); 
+    return real2(
         (a.x * b.x + a.y * b.y) / den,
         (a.y * b.x - a.x * b.y) / den
     );
 }
-vec2 complexSq(vec2 z) { return complexMul(z, z); }
-vec2 complexCube(vec2 z) { return complexMul(complexSq(z), z); }
+real2 complexSq(real2 z) { return complexMul(z, z); }
+real2 complexCube(real2 z) { return complexMul(complexSq(z), z); }
 
-float fractalFunction(in vec2 c)
+real fractalFunction(in real2 c)
 {
-    float n = 0.0;
-    vec2 z = c; 
-    vec2 z_prev;
+    real n = 0.0;
+    real2 z = c; 
+    real2 z_prev;
 
-    const float CONVERGENCE_THRESHOLD_SQ = 0.000001; 
+    const real CONVERGENCE_THRESHOLD_SQ = 0.000001; 
 
     for (int i = 0; i < maxIterations; i++) {
         z_prev = z; 
 
-        vec2 f_z = complexSub(complexCube(z), vec2(1.0, 0.0));
+        real2 f_z = complexSub(complexCube(z), real2(1.0, 0.0));
 
-        vec2 f_prime_z = complexMul(vec2(3.0, 0.0), complexSq(z));
+        real2 f_prime_z = complexMul(real2(3.0, 0.0), complexSq(z));
 
         if (dot(f_prime_z, f_prime_z) < CONVERGENCE_THRESHOLD_SQ * 100.0) { 
-            n = float(maxIterations); 
+            n = real(maxIterations); 
             break;
         }
 
-        vec2 delta_z = complexDiv(f_z, f_prime_z);
+        real2 delta_z = complexDiv(f_z, f_prime_z);
 
         z = complexSub(z, delta_z);
 
@@ -45,9 +45,56 @@ float fractalFunction(in vec2 c)
         n += 1.0;
     }
 
-    if (n >= float(maxIterations)) {
+    if (n >= real(maxIterations)) {
         return 0.0; 
     } else {
         return n; 
     }
-}
\ No newline at end of file
+}
+
+#ifdef FRACTAL_DOUBLE_DOUBLE
+dvec4 ddcDiv(dvec4 a, dvec4 b)
+{
+    dvec2 den = ddAdd(ddSqr(b.xy), ddSqr(b.zw));
+    if (den.x == 0.0) return dvec4(0.0);
+    return dvec4(
+        ddDiv(ddAdd(ddMul(a.xy, b.xy), ddMul(a.zw, b.zw)), den),
+        ddDiv(ddSub(ddMul(a.zw, b.xy), ddMul(a.xy, b.zw)), den)
+    );
+}
+
+double fractalFunctionDD(in dvec4 c)
+{
+    double n = 0.0;
+    dvec4 z = c;
+
+    const double CONVERGENCE_THRESHOLD_SQ = 0.000001;
+
+    for (int i = 0; i < maxIterations; i++) {
+        dvec4 z_sq = ddcSqr(z);
+        dvec4 f_z = ddcSub(ddcMul(z_sq, z), dvec4(1.0, 0.0, 0.0, 0.0));
+        dvec4 f_prime_z = dvec4(ddMulDouble(z_sq.xy, 3.0), ddMulDouble(z_sq.zw, 3.0));
+
+        if (ddcNormSq(f_prime_z) < CONVERGENCE_THRESHOLD_SQ * 100.0) {
+            n = double(maxIterations);
+            break;
+        }
+
+        dvec4 delta_z = ddcDiv(f_z, f_prime_z);
+        z = ddcSub(z, delta_z);
+
+        if (ddcNormSq(delta_z) < CONVERGENCE_THRESHOLD_SQ) {
+            n += 1.0;
+            break;
+        }
+
+        n += 1.0;
+    }
+
+    if (n >= double(maxIterations)) {
+        return 0.0;
+    } else {
+        return n;
+    }
+}
+#endif
@@ -0,0 +1,140 @@
+#ifndef PERTURBATION_GLSL
+#define PERTURBATION_GLSL
+
+// Deep-zoom path: the view center's orbit Z is computed in arbitrary precision on the CPU and each pixel only
+// iterates its delta dz = z - Z, which stays representable in double long after pixelToComplex collapses.
+
+layout(std430, binding = 1) readonly buffer ReferenceOrbit {
+    dvec2 referenceOrbit[];
+};
+
+// Index of the last point in referenceOrbit.
+uniform int referenceLength;
+
+#if defined(FRACTAL_MANDELBROT)
+// dz_{m+l} = a * dz_m + b * dc while |dz_m| < radius; see BlaTable for the level layout.
+struct BlaStep {
+    dvec2 a;
+    dvec2 b;
+    double radius;
+};
+
+layout(std430, binding = 2) readonly buffer BlaTable {
+    BlaStep blaSteps[];
+};
+
+uniform bool useBla;
+uniform int blaLevelCount;
+
+// Longest entry starting at reference index ref that is valid for dz and fits in the remaining iterations.
+// Returns its length (0 when none applies) and its index in blaSteps.
+int findBla(int ref, double dzNormSq, int remaining, out int index)
+{
+    index = 0;
+    if (!useBla || ref < 1)
+        return 0;
+
+    int skip = 0;
+    int levelOffset = 0;
+    int count = referenceLength - 1;
+    for (int level = 0; level < blaLevelCount; level++) {
+        int span = 1 << level;
+        int j = (ref - 1) >> level;
+        if (((ref - 1) & (span - 1)) != 0 || span > remaining || j >= count)
+            break;
+
+        double radius = blaSteps[levelOffset + j].radius;
+        if (dzNormSq >= radius * radius)
+            break;
+
+        index = levelOffset + j;
+        skip = span;
+        levelOffset += count;
+        count /= 2;
+    }
+    return skip;
+}
+
+dvec2 complexMul(dvec2 a, dvec2 b)
+{
+    return dvec2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+}
+#endif
+
+// |c + d| - |c| without the cancellation of evaluating both absolute values.
+double diffAbs(double c, double d)
+{
+    if (c >= 0.0)
+        return (c + d >= 0.0) ? d : -(2.0 * c + d);
+    return (c + d > 0.0) ? 2.0 * c + d : -d;
+}
+
+dvec2 perturbStep(dvec2 Z, dvec2 dz, dvec2 dc)
+{
+    double x = (2.0 * Z.x + dz.x) * dz.x - (2.0 * Z.y + dz.y) * dz.y;
+#if defined(FRACTAL_TRICORN)
+    double y = -2.0 * (Z.x * dz.y + Z.y * dz.x + dz.x * dz.y);
+#elif defined(FRACTAL_BURNING_SHIP)
+    double y = 2.0 * diffAbs(Z.x * Z.y, Z.x * dz.y + Z.y * dz.x + dz.x * dz.y);
+#else
+    double y = 2.0 * (Z.x * dz.y + Z.y * dz.x + dz.x * dz.y);
+#endif
+    return dvec2(x, y) + dc;
+}
+
+double perturbedFractalFunction(in dvec2 dc)
+{
+    dvec2 dz = dvec2(0.0);
+    dvec2 z = dvec2(0.0);
+    int ref = 0;
+    int iteration = 0;
+    bool escaped = false;
+
+    while (iteration < maxIterations) {
+#if defined(FRACTAL_MANDELBROT)
+        int blaIndex;
+        int skip = findBla(ref, dot(dz, dz), maxIterations - iteration, blaIndex);
+        if (skip > 0) {
+            dz = complexMul(blaSteps[blaIndex].a, dz) + complexMul(blaSteps[blaIndex].b, dc);
+            ref += skip;
+            iteration += skip;
+        } else
+#endif
+        {
+            dz = perturbStep(referenceOrbit[ref], dz, dc);
+            ref++;
+            iteration++;
+        }
+
+        z = referenceOrbit[ref] + dz;
+        double r2 = dot(z, z);
+        if (r2 > (escapeRadius * escapeRadius)) {
+            escaped = true;
+            break;
+        }
+
+        // Rebase onto Z_0 = 0 once the delta dominates or the reference has run out.
+        if (r2 < dot(dz, dz) || ref == referenceLength) {
+            dz = z;
+            ref = 0;
+        }
+    }
+
+    if (!escaped)
+        return 0.0;
+
+    // The escaping step itself is not counted, as in fractalFunction.
+    double n = double(iteration - 1);
+
+#if defined(FRACTAL_TRICORN)
+    bool smoothing = true;
+#else
+    bool smoothing = useSmoothing;
+#endif
+    if (smoothing)
+        return n - log2_d(log2_d(dot(z, z))) + 4.0;
+
+    return n;
+}
+
+#endif
@@ -0,0 +1,38 @@
+#version 430
+
+// Filters supersamples down to output pixels along one axis. Output pixel p takes the weighted sum of the samples
+// p * factor + k, k < tapCount, along `axis` and copies the other coordinate through; the weights come from
+// Supersampling::getWeights. One dispatch across the rows and one down the columns make the separable 2D filter.
+
+layout (local_size_x = 16, local_size_y = 16) in;
+
+const int MAX_TAPS = 56; // Supersampling::MAX_TAPS
+
+layout (binding = 1) uniform sampler2D sourceImage;
+// Written without a format qualifier: the first pass goes to an rgba16f scratch image that keeps the negative lobes
+// of Mitchell and Lanczos, the second to the rgba8 result, which clamps on store.
+layout (binding = 0) uniform writeonly image2D destImage;
+
+uniform int axis;
+uniform int factor;
+uniform int tapCount;
+uniform float weights[MAX_TAPS];
+
+void main()
+{
+    ivec2 pixelCoord = ivec2(gl_GlobalInvocationID.xy);
+
+    if (any(greaterThanEqual(pixelCoord, imageSize(destImage))))
+        return;
+
+    ivec2 sampleCoord = pixelCoord;
+    sampleCoord[axis] *= factor;
+    ivec2 step = ivec2(0);
+    step[axis] = 1;
+
+    vec4 sum = vec4(0.0);
+    for (int k = 0; k < tapCount; ++k)
+        sum += weights[k] * texelFetch(sourceImage, sampleCoord + k * step, 0);
+
+    imageStore(destImage, pixelCoord, sum);
+}
@@ -1,18 +1,23 @@
-float fractalFunction(in vec2 c)
+real fractalFunction(in real2 c)
 {
-    float n = 0.0;
-    vec2 z = vec2(0.0);
+    real n = 0.0;
+    real2 z = real2(0.0);
+    CycleDetector cycles = startCycleDetection(z);
     for (int i = 0; i < maxIterations; i++) {
-        z = vec2(z.x * z.x - z.y * z.y, -2.0 * z.x * z.y) + c;
+        z = real2(z.x * z.x - z.y * z.y, -2.0 * z.x * z.y) + c;
 
-        if (dot(z, z) > (escapeRadius * escapeRadius))
+        if (dot(z, z) > escapeRadiusSq)
             break;
         n += 1.0;
+        if (orbitCycled(cycles, z)) {
+            n = real(maxIterations);
+            break;
+        }
     }
 
-    if (n >= float(maxIterations))
+    if (n >= real(maxIterations))
         return 0.0;
 
-    float smoothCount = n - log2(log2(dot(z, z))) + 4.0;
+    real smoothCount = n - log2_r(log2_r(dot(z, z))) + 4.0;
     return smoothCount;
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "AnimationExporter.hpp"
+
+#include <algorithm>
+#include <format>
+#include <system_error>
+#include <utility>
+
+#include "gfx/ImageExport.hpp"
+#include "util/Logger.hpp"
+
+namespace
+{
+	constexpr auto FRAME_FILE_FORMAT = "frame_{:05}{}";
+}
+
+AnimationExporter::AnimationExporter(FractalComputer& computer, AnimationRequest request)
+	: m_computer(computer), m_request(std::move(request)),
+	  m_frameCount(Keyframes::getFrameCount(m_request.keyframes, m_request.framesPerSecond)),
+	  m_maxPendingEncodes(static_cast<int>(std::max(1U, computer.getScheduler().getWorkerCount()))),
+	  m_start(std::chrono::steady_clock::now())
+{
+	std::error_code error;
+	std::filesystem::create_directories(m_request.outputDirectory, error);
+	if (error)
+	{
+		FRACTAL_ERROR("Cannot create animation folder {}: {}", m_request.outputDirectory.string(), error.message());
+		m_frameCount = 0;
+		return;
+	}
+
+	if (m_request.baseState.backend == RenderBackend::GPU)
+	{
+		for (Slot& slot : m_slots)
+		{
+			slot.iterations = std::make_unique<Texture>(m_request.width, m_request.height, GL_R32F);
+			slot.image = std::make_unique<Texture>(m_request.width, m_request.height);
+		}
+	}
+	FRACTAL_INFO("Rendering {} animation frames at {}x{} to {}", m_frameCount, m_request.width, m_request.height,
+				 m_request.outputDirectory.string());
+}
+
+AnimationExporter::~AnimationExporter()
+{
+	std::unique_lock lock(m_encodeMutex);
+	m_encodeCondition.wait(lock, [this] { return m_pendingEncodes == 0; });
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+	if (m_writtenFrames + m_failedFrames < m_frameCount)
+	{
+		FRACTAL_WARN("Animation export stopped after {} of {} frames.", m_writtenFrames, m_frameCount);
+	}
+	else if (m_frameCount > 0)
+	{
+		FRACTAL_INFO("Animation export wrote {} of {} frames in {:.1f} s ({:.1f} frames/s).", m_writtenFrames,
+					 m_frameCount, elapsed.count(), m_frameCount / std::max(elapsed.count(), 1e-9));
+	}
+}
+
+bool AnimationExporter::advance()
+{
+	if (m_request.baseState.backend == RenderBackend::GPU)
+	{
+		// Finished readbacks go to the encoders in frame order, unless those are saturated; the slots then stay
+		// occupied and hold back new frames until the encoders catch up.
+		while (m_collectedFrames < m_startedFrames && getPendingEncodes() < m_maxPendingEncodes)
+		{
+			Slot& slot = m_slots[static_cast<size_t>(m_collectedFrames) % SLOT_COUNT];
+			if (!slot.readback.isReady())
+				break;
+			queueEncode(m_collectedFrames, slot.readback.finish());
+			++m_collectedFrames;
+		}
+
+		// Starting one frame per call keeps at most one animation frame of GPU work queued ahead of the UI.
+		if (m_startedFrames < m_frameCount && m_startedFrames - m_collectedFrames < static_cast<int>(SLOT_COUNT))
+		{
+			Slot& slot = m_slots[static_cast<size_t>(m_startedFrames) % SLOT_COUNT];
+			m_computer.renderToTexture(getFrameState(m_startedFrames), *slot.iterations, *slot.image);
+			slot.readback.start(*slot.image);
+			++m_startedFrames;
+		}
+	}
+	else if (m_startedFrames < m_frameCount && getPendingEncodes() < m_maxPendingEncodes)
+	{
+		// The CPU backend renders on the worker pool right here, overlapping the encoding of earlier frames.
+		std::vector<uint8_t> pixels = m_computer.renderImage(getFrameState(m_startedFrames), m_request.width,
+															 m_request.height);
+		ImageExport::flipRows(m_computer.getScheduler(), pixels, m_request.width, m_request.height);
+		queueEncode(m_startedFrames, std::move(pixels));
+		m_collectedFrames = ++m_startedFrames;
+	}
+
+	std::lock_guard lock(m_encodeMutex);
+	return m_writtenFrames + m_failedFrames < m_frameCount;
+}
+
+int AnimationExporter::getFramesWritten() const
+{
+	std::lock_guard lock(m_encodeMutex);
+	return m_writtenFrames;
+}
+
+FractalState AnimationExporter::getFrameState(int frame) const
+{
+	FractalState state = m_request.baseState;
+	state.renderWidth = m_request.width;
+	state.renderHeight = m_request.height;
+
+	const double time = m_request.keyframes.front().time + (static_cast<double>(frame) / m_request.framesPerSecond);
+	Keyframes::apply(m_request.keyframes, time, state);
+	return state;
+}
+
+int AnimationExporter::getPendingEncodes() const
+{
+	std::lock_guard lock(m_encodeMutex);
+	return m_pendingEncodes;
+}
+
+void AnimationExporter::queueEncode(int frame, std::vector<uint8_t> pixels)
+{
+	ScreenshotRequest request;
+	request.format = m_request.format;
+	request.filepath = m_request.outputDirectory
+					   / std::format(FRAME_FILE_FORMAT, frame, ImageExport::getExtension(m_request.format));
+
+	{
+		std::lock_guard lock(m_encodeMutex);
+		++m_pendingEncodes;
+	}
+	auto shared = std::make_shared<std::vector<uint8_t>>(std::move(pixels));
+	m_computer.getScheduler().submit([this, request, shared, width = m_request.width, height = m_request.height]() {
+		const bool saved = !shared->empty() && ImageExport::save(request, width, height, *shared);
+		std::lock_guard lock(m_encodeMutex);
+		--m_pendingEncodes;
+		if (saved)
+			++m_writtenFrames;
+		else
+			++m_failedFrames;
+		m_encodeCondition.notify_all();
+	});
+}
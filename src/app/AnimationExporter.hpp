@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "fractal/FractalComputer.hpp"
+#include "fractal/Keyframes.hpp"
+#include "gfx/PixelReadback.hpp"
+#include "gfx/Texture.hpp"
+#include "ui/UIState.hpp"
+
+struct AnimationRequest
+{
+		std::vector<Keyframe> keyframes; // Sorted by time.
+		FractalState baseState;			 // Backend and render settings; the keyframes supply the view.
+		std::filesystem::path outputDirectory;
+		ScreenshotFormat format = ScreenshotFormat::PNG;
+		int framesPerSecond = 30;
+		int width = 1920;
+		int height = 1080;
+};
+
+// Renders a keyframe animation to numbered image files while the viewer keeps running. On the GPU backend frames
+// move through a ring of slots, so while frame k is being encoded on a worker, frame k + 1 is being read back and
+// frame k + 2 is computing; throughput is set by the slowest stage rather than by their sum. advance() never waits
+// on the GPU or the encoders, it only moves along the frames whose previous stage has finished.
+class AnimationExporter
+{
+	public:
+		AnimationExporter(FractalComputer& computer, AnimationRequest request);
+		// Frames not yet rendered are dropped; frames already handed to the encoders are still written.
+		~AnimationExporter();
+
+		AnimationExporter(const AnimationExporter&) = delete;
+		AnimationExporter& operator=(const AnimationExporter&) = delete;
+		AnimationExporter(AnimationExporter&&) = delete;
+		AnimationExporter& operator=(AnimationExporter&&) = delete;
+
+		// Collects finished frames and starts the next one if a slot is free. Meant to be called on every pass of the
+		// render loop; returns false once every frame has been written.
+		bool advance();
+
+		[[nodiscard]] int getFrameCount() const { return m_frameCount; }
+		[[nodiscard]] int getFramesWritten() const;
+
+	private:
+		// Frames in flight on the GPU: one computing, one reading back, and one more queued behind them.
+		static constexpr size_t SLOT_COUNT = 3;
+
+		struct Slot
+		{
+				std::unique_ptr<Texture> iterations;
+				std::unique_ptr<Texture> image;
+				PixelReadback readback;
+		};
+
+		[[nodiscard]] FractalState getFrameState(int frame) const;
+		[[nodiscard]] int getPendingEncodes() const;
+		// Encodes top-to-bottom pixels on a worker.
+		void queueEncode(int frame, std::vector<uint8_t> pixels);
+
+		FractalComputer& m_computer;
+		AnimationRequest m_request;
+		int m_frameCount = 0;
+		int m_startedFrames = 0;
+		int m_collectedFrames = 0; // Frames whose pixels have left the GPU.
+		std::array<Slot, SLOT_COUNT> m_slots;
+		int m_maxPendingEncodes = 1;
+		std::chrono::steady_clock::time_point m_start;
+
+		// Shared with the encode tasks.
+		mutable std::mutex m_encodeMutex;
+		std::condition_variable m_encodeCondition;
+		int m_pendingEncodes = 0;
+		int m_writtenFrames = 0;
+		int m_failedFrames = 0;
+};
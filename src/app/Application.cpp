@@ -2,6 +2,7 @@
 
 #include <fstream>
 #include <optional>
+#include <stdexcept>
 
 #include <SDL3/SDL.h>
 
@@ -21,17 +22,55 @@ Application::Application()
 	FRACTAL_INFO("Initializing FractaVista...");
 
 	m_window = std::make_unique<Window>("FractaVista", DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT);
-	m_fractalComputer = std::make_unique<FractalComputer>(DEFAULT_WINDOW_WIDTH,
-														  DEFAULT_WINDOW_HEIGHT);
+	m_renderThread = std::make_unique<RenderThread>(m_window->getSDLWindow(), DEFAULT_WINDOW_WIDTH,
+													DEFAULT_WINDOW_HEIGHT);
 	m_uiManager = std::make_unique<UIManager>(m_window->getSDLWindow(), m_window->getGLContext());
 
+	m_renderThread->addStep([this](FractalComputer&) {
+		advanceAnimationExport();
+		advanceTiledExport();
+	});
+
 	m_uiManager->onRequestRedraw = [this]() { m_fractalState.needsUpdate = true; };
 
-	m_uiManager->onRequestScreenshot
-		= [this](const ScreenshotRequest& request) { m_fractalComputer->saveScreenshot(request, m_fractalState); };
+	m_uiManager->onRequestScreenshot = [this](const ScreenshotRequest& request) {
+		if (request.tiled)
+		{
+			startTiledExport(request);
+			return;
+		}
+		m_renderThread->post([request, state = m_fractalState](FractalComputer& computer) {
+			computer.saveScreenshot(request, state);
+		});
+	};
+
+	m_uiManager->onValidateIterationSkipping = [this]() {
+		m_renderThread->post(
+			[state = m_fractalState](FractalComputer& computer) { computer.validateIterationSkipping(state); });
+	};
+	m_uiManager->onCompareTileScheduling = [this]() {
+		m_renderThread->post(
+			[state = m_fractalState](FractalComputer& computer) { computer.compareTileScheduling(state); });
+	};
 
 	m_uiManager->onQuit = [this]() { m_isRunning = false; };
 
+	m_uiManager->onRenderAnimation = [this]() { startAnimationExport(); };
+
+	m_uiManager->onCancelAnimation = [this]() {
+		m_renderThread->post([this](FractalComputer&) {
+			m_animationExporter.reset();
+			m_animationProgress.isRunning.store(false, std::memory_order_release);
+		});
+	};
+
+	m_uiManager->onCancelTiledExport = [this]() {
+		m_renderThread->post([this](FractalComputer&) {
+			m_tiledExporter.reset();
+			m_tiledProgress.isRunning.store(false, std::memory_order_release);
+		});
+	};
+
 	m_uiManager->onSavePreset = [this]() {
 		const std::vector<nfdfilteritem_t> filter = { { .name = "FractaVista Preset", .spec = "fracta" } };
 
@@ -84,6 +123,24 @@ Application::Application()
 	};
 }
 
+Application::~Application()
+{
+	try
+	{
+		m_renderThread->invoke([this](FractalComputer&) {
+			m_animationExporter.reset();
+			m_tiledExporter.reset();
+		});
+	}
+	catch (const std::exception& e)
+	{
+		// The render thread failed; the exporters are released from this thread's context instead.
+		FRACTAL_WARN("Releasing exports without the render thread: {}", e.what());
+	}
+	// The render loop advances the exporters, so it has to stop before they are destroyed.
+	m_renderThread.reset();
+}
+
 void Application::run()
 {
 	m_fractalState.needsUpdate = true;
@@ -111,14 +168,17 @@ void Application::processInput()
 
 void Application::update()
 {
-	m_uiManager->update(m_fractalState, m_uiState, *m_fractalComputer);
+	const RenderedFrame& frame = m_renderThread->acquireFrame();
+	updateExportProgress();
+	m_uiManager->update(m_fractalState, m_uiState, frame.stats, frame.texture->getID());
 }
 
 void Application::render()
 {
+	// The render thread picks up the latest state on its own; the UI never waits for a fractal frame.
 	if (m_fractalState.needsUpdate)
 	{
-		m_fractalComputer->generate(m_fractalState);
+		m_renderThread->submit(m_fractalState);
 		m_fractalState.needsUpdate = false;
 	}
 
@@ -126,3 +186,95 @@ void Application::render()
 	m_uiManager->render();
 	m_window->swapBuffers();
 }
+
+void Application::startAnimationExport()
+{
+	if (m_uiState.keyframes.size() < 2 || m_animationProgress.isRunning.load(std::memory_order_acquire))
+		return;
+
+	AnimationRequest request;
+	request.keyframes = m_uiState.keyframes;
+	request.baseState = m_fractalState;
+	request.outputDirectory = m_uiState.animationFolder;
+	request.format = m_uiState.animationFormat;
+	request.framesPerSecond = m_uiState.animationFramesPerSecond;
+	request.width = m_uiState.animationWidth;
+	request.height = m_uiState.animationHeight;
+
+	m_animationProgress.done.store(0, std::memory_order_relaxed);
+	m_animationProgress.total.store(0, std::memory_order_relaxed);
+	m_animationProgress.isRunning.store(true, std::memory_order_release);
+	m_renderThread->post([this, request = std::move(request)](FractalComputer& computer) mutable {
+		try
+		{
+			m_animationExporter = std::make_unique<AnimationExporter>(computer, std::move(request));
+		}
+		catch (...)
+		{
+			m_animationProgress.isRunning.store(false, std::memory_order_release);
+			throw;
+		}
+		m_animationProgress.total.store(m_animationExporter->getFrameCount(), std::memory_order_relaxed);
+	});
+}
+
+void Application::advanceAnimationExport()
+{
+	if (!m_animationExporter)
+		return;
+
+	if (m_animationExporter->advance())
+	{
+		m_animationProgress.done.store(m_animationExporter->getFramesWritten(), std::memory_order_relaxed);
+		return;
+	}
+	m_animationExporter.reset();
+	m_animationProgress.isRunning.store(false, std::memory_order_release);
+}
+
+void Application::startTiledExport(const ScreenshotRequest& request)
+{
+	if (m_tiledProgress.isRunning.load(std::memory_order_acquire))
+		return;
+
+	m_tiledProgress.done.store(0, std::memory_order_relaxed);
+	m_tiledProgress.total.store(0, std::memory_order_relaxed);
+	m_tiledProgress.isRunning.store(true, std::memory_order_release);
+	m_renderThread->post([this, request, state = m_fractalState](FractalComputer& computer) {
+		try
+		{
+			m_tiledExporter = std::make_unique<TiledExporter>(computer, request, state);
+			m_tiledProgress.total.store(m_tiledExporter->getHeight(), std::memory_order_relaxed);
+		}
+		catch (const std::runtime_error& e)
+		{
+			FRACTAL_ERROR("Cannot start the tiled export: {}", e.what());
+			m_tiledProgress.isRunning.store(false, std::memory_order_release);
+		}
+	});
+}
+
+void Application::advanceTiledExport()
+{
+	if (!m_tiledExporter)
+		return;
+
+	if (m_tiledExporter->advance())
+	{
+		m_tiledProgress.done.store(m_tiledExporter->getRowsWritten(), std::memory_order_relaxed);
+		return;
+	}
+	m_tiledExporter.reset();
+	m_tiledProgress.isRunning.store(false, std::memory_order_release);
+}
+
+void Application::updateExportProgress()
+{
+	m_uiState.isExportingAnimation = m_animationProgress.isRunning.load(std::memory_order_acquire);
+	m_uiState.animationFramesWritten = m_animationProgress.done.load(std::memory_order_relaxed);
+	m_uiState.animationFrameCount = m_animationProgress.total.load(std::memory_order_relaxed);
+
+	m_uiState.isExportingTiles = m_tiledProgress.isRunning.load(std::memory_order_acquire);
+	m_uiState.tiledRowsWritten = m_tiledProgress.done.load(std::memory_order_relaxed);
+	m_uiState.tiledRowCount = m_tiledProgress.total.load(std::memory_order_relaxed);
+}
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 
+#include "app/AnimationExporter.hpp"
+#include "app/RenderThread.hpp"
+#include "app/TiledExporter.hpp"
 #include "core/Window.hpp"
-#include "fractal/FractalComputer.hpp"
 #include "fractal/FractalState.hpp"
 #include "ui/UIManager.hpp"
 #include "ui/UIState.hpp"
@@ -13,18 +16,48 @@ class Application
 {
 	public:
 		Application();
+		// Destroys the exporters on the render thread, which owns their GL objects.
+		~Application();
+
+		Application(const Application&) = delete;
+		Application& operator=(const Application&) = delete;
+		Application(Application&&) = delete;
+		Application& operator=(Application&&) = delete;
+
 		void run();
 
 	private:
 		void processInput();
 		void update();
 		void render();
+		// Progress of an export, written on the render thread and read on the UI thread.
+		struct ExportProgress
+		{
+				std::atomic<bool> isRunning{ false }; // Set when the UI starts the export, cleared once it is gone.
+				std::atomic<int> done{ 0 };
+				std::atomic<int> total{ 0 };
+		};
+
+		void startAnimationExport();
+		// Called by the render loop: moves a running animation export along and publishes its progress.
+		void advanceAnimationExport();
+		void startTiledExport(const ScreenshotRequest& request);
+		// Called by the render loop: moves a running tiled export along and publishes its progress.
+		void advanceTiledExport();
+		// Copies the exports' progress into the UI state.
+		void updateExportProgress();
 
 		bool m_isRunning = true;
 
 		std::unique_ptr<Window> m_window;
-		std::unique_ptr<FractalComputer> m_fractalComputer;
+		// Owns the FractalComputer. The exporters use it and are only created, advanced and destroyed on its thread,
+		// whose loop advances them between frames without the UI waiting.
+		std::unique_ptr<RenderThread> m_renderThread;
 		std::unique_ptr<UIManager> m_uiManager;
+		std::unique_ptr<AnimationExporter> m_animationExporter;
+		std::unique_ptr<TiledExporter> m_tiledExporter;
+		ExportProgress m_animationProgress;
+		ExportProgress m_tiledProgress;
 
 		FractalState m_fractalState;
 		UIState m_uiState;
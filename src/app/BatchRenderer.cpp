@@ -0,0 +1,285 @@
+#include "BatchRenderer.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "fractal/Supersampling.hpp"
+#include "gfx/ImageExport.hpp"
+#include "util/JsonUtils.hpp"
+#include "util/Logger.hpp"
+
+namespace
+{
+	// Finished images waiting for the encoder; beyond this, rendering waits instead of piling up memory.
+	constexpr int MAX_PENDING_WRITES = 4;
+	constexpr int MAX_SCALE = 16;
+	// The GPU backend renders into a single texture; its size only matters for the interactive view.
+	constexpr int COMPUTER_TEXTURE_SIZE = 16;
+
+	constexpr std::string_view USAGE = R"(Usage: fractavista-render [options] <preset.fracta>...
+
+Renders each preset to <output>/<preset name>.<format> without opening a window.
+
+Options:
+  --output <dir>         Directory for the images (default: current directory)
+  --width <pixels>       Image width before scaling (default: from the preset)
+  --height <pixels>      Image height before scaling (default: from the preset)
+  --scale <n>            Render n times larger in each direction (default: 1)
+  --supersample <n>      Anti-alias with n x n samples per pixel, up to 8 (default: 1)
+  --filter <box|mitchell|lanczos>
+                         Filter that resolves the samples (default: mitchell)
+  --backend <gpu|cpu>    gpu uses an offscreen OpenGL context; cpu needs no OpenGL (default: gpu)
+  --format <png|jpg|bmp> Image format (default: png)
+  --help                 Show this message
+)";
+
+	int parsePositive(std::string_view option, std::string_view text, int maximum)
+	{
+		int value = 0;
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (error != std::errc() || end != text.data() + text.size() || value <= 0 || value > maximum)
+		{
+			throw std::invalid_argument(std::format("{} expects a whole number from 1 to {}, got '{}'", option,
+													maximum, text));
+		}
+		return value;
+	}
+}
+
+std::optional<BatchOptions> BatchRenderer::parseArguments(int argc, char** argv)
+{
+	BatchOptions options;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view argument = argv[i];
+		if (argument == "--help")
+		{
+			std::cout << USAGE;
+			return std::nullopt;
+		}
+		if (!argument.starts_with("--"))
+		{
+			options.presets.emplace_back(argument);
+			continue;
+		}
+
+		if (i + 1 >= argc)
+		{
+			throw std::invalid_argument(std::format("{} needs a value", argument));
+		}
+		const std::string_view value = argv[++i];
+
+		if (argument == "--output")
+			options.outputDirectory = value;
+		else if (argument == "--width")
+			options.width = parsePositive(argument, value, std::numeric_limits<int>::max());
+		else if (argument == "--height")
+			options.height = parsePositive(argument, value, std::numeric_limits<int>::max());
+		else if (argument == "--scale")
+			options.scale = parsePositive(argument, value, MAX_SCALE);
+		else if (argument == "--supersample")
+			options.supersample = parsePositive(argument, value, Supersampling::MAX_FACTOR);
+		else if (argument == "--filter" && value == "box")
+			options.filter = ResolveFilter::Box;
+		else if (argument == "--filter" && value == "mitchell")
+			options.filter = ResolveFilter::Mitchell;
+		else if (argument == "--filter" && value == "lanczos")
+			options.filter = ResolveFilter::Lanczos;
+		else if (argument == "--backend" && (value == "gpu" || value == "cpu"))
+			options.backend = value == "gpu" ? RenderBackend::GPU : RenderBackend::CPU;
+		else if (argument == "--format" && value == "png")
+			options.format = ScreenshotFormat::PNG;
+		else if (argument == "--format" && value == "jpg")
+			options.format = ScreenshotFormat::JPG;
+		else if (argument == "--format" && value == "bmp")
+			options.format = ScreenshotFormat::BMP;
+		else
+			throw std::invalid_argument(std::format("Unknown option or value: {} {}", argument, value));
+	}
+
+	if (options.presets.empty())
+	{
+		throw std::invalid_argument("No preset files given");
+	}
+	return options;
+}
+
+BatchRenderer::BatchRenderer(BatchOptions options) : m_options(std::move(options))
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	m_scheduler = std::make_unique<TaskScheduler>();
+	if (m_options.backend == RenderBackend::GPU)
+	{
+		m_context = std::make_unique<OffscreenContext>();
+		m_fractalComputer = std::make_unique<FractalComputer>(COMPUTER_TEXTURE_SIZE, COMPUTER_TEXTURE_SIZE);
+	}
+	else
+	{
+		m_cpuRenderer = std::make_unique<CpuFractalRenderer>(*m_scheduler);
+	}
+
+	std::filesystem::create_directories(m_options.outputDirectory);
+
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	FRACTAL_INFO("Batch renderer ready in {:.1f} ms.", elapsed.count());
+}
+
+BatchRenderer::~BatchRenderer()
+{
+	waitForWrites(0);
+}
+
+int BatchRenderer::run()
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	int failed = 0;
+	for (const auto& preset : m_options.presets)
+	{
+		if (!renderPreset(preset))
+			++failed;
+	}
+	waitForWrites(0);
+	failed += std::exchange(m_failedWrites, 0);
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	FRACTAL_INFO("Rendered {} of {} presets in {:.2f} s.", static_cast<int>(m_options.presets.size()) - failed,
+				 m_options.presets.size(), elapsed.count());
+	return failed;
+}
+
+bool BatchRenderer::renderPreset(const std::filesystem::path& presetPath)
+{
+	FractalState state;
+	try
+	{
+		std::ifstream file(presetPath);
+		if (!file.is_open())
+		{
+			FRACTAL_ERROR("Failed to open preset {}", presetPath.string());
+			return false;
+		}
+		json j;
+		file >> j;
+		state = j.get<FractalState>();
+	}
+	catch (const json::exception& e)
+	{
+		FRACTAL_ERROR("Failed to parse preset file {}: {}", presetPath.string(), e.what());
+		return false;
+	}
+
+	state.backend = m_options.backend;
+	if (m_options.width > 0)
+		state.renderWidth = m_options.width;
+	if (m_options.height > 0)
+		state.renderHeight = m_options.height;
+
+	const int width = state.renderWidth * m_options.scale;
+	const int height = state.renderHeight * m_options.scale;
+	if (width <= 0 || height <= 0)
+	{
+		FRACTAL_ERROR("Preset {} has an invalid size ({}x{}).", presetPath.string(), width, height);
+		return false;
+	}
+
+	ScreenshotRequest request;
+	request.filepath = m_options.outputDirectory / presetPath.stem();
+	request.filepath += ImageExport::getExtension(m_options.format);
+	request.format = m_options.format;
+	request.scale = m_options.scale;
+	request.supersample = m_options.supersample;
+	request.filter = m_options.filter;
+
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<uint8_t> pixels;
+	try
+	{
+		if (m_fractalComputer)
+		{
+			pixels = m_fractalComputer->renderImage(state, width, height, m_options.supersample, m_options.filter);
+		}
+		else if (m_options.supersample > 1)
+		{
+			state.renderWidth = width;
+			state.renderHeight = height;
+			const FractalState sampleView = Supersampling::getSampleView(state, m_options.supersample,
+																		 m_options.filter);
+			pixels = Supersampling::resolve(*m_scheduler,
+											renderOnCpu(sampleView, sampleView.renderWidth, sampleView.renderHeight),
+											width, height, m_options.supersample, m_options.filter);
+		}
+		else
+		{
+			pixels = renderOnCpu(state, width, height);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		FRACTAL_ERROR("Failed to render {}: {}", presetPath.string(), e.what());
+		return false;
+	}
+
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	FRACTAL_INFO("Rendered {} at {}x{} in {:.1f} ms.", presetPath.filename().string(), width, height, elapsed.count());
+
+	queueWrite(request, width, height, std::move(pixels));
+	return true;
+}
+
+std::vector<uint8_t> BatchRenderer::renderOnCpu(const FractalState& state, int width, int height)
+{
+	// The CPU kernels have no double-double tier, so only the switch to perturbation matters here.
+	const ReferenceOrbit* reference = nullptr;
+	if (selectPrecision(state, height, KernelPrecision::Float) == KernelPrecision::Perturbation)
+	{
+		m_referenceOrbit.update(state.type, state.offset.x, state.offset.y, state.zoom, height, state.maxIterations);
+		reference = &m_referenceOrbit;
+	}
+
+	const BlaTable* bla = nullptr;
+	if (reference != nullptr && state.useIterationSkipping && BlaTable::supports(state.type))
+	{
+		m_blaTable.build(*reference, BlaTable::maxPixelDelta(width, height, state.zoom));
+		bla = m_blaTable.isEmpty() ? nullptr : &m_blaTable;
+	}
+
+	std::vector<uint8_t> pixels;
+	m_cpuRenderer->render(state, width, height, pixels, reference, bla);
+	return pixels;
+}
+
+void BatchRenderer::queueWrite(const ScreenshotRequest& request, int width, int height, std::vector<uint8_t> pixels)
+{
+	waitForWrites(MAX_PENDING_WRITES - 1);
+	ImageExport::flipRows(*m_scheduler, pixels, width, height);
+
+	{
+		std::lock_guard lock(m_writeMutex);
+		++m_pendingWrites;
+	}
+	auto shared = std::make_shared<std::vector<uint8_t>>(std::move(pixels));
+	m_scheduler->submit([this, request, width, height, shared]() {
+		const bool saved = ImageExport::save(request, width, height, *shared);
+		std::lock_guard lock(m_writeMutex);
+		--m_pendingWrites;
+		if (!saved)
+			++m_failedWrites;
+		m_writeCondition.notify_all();
+	});
+}
+
+void BatchRenderer::waitForWrites(int maxPending)
+{
+	std::unique_lock lock(m_writeMutex);
+	m_writeCondition.wait(lock, [&] { return m_pendingWrites <= maxPending; });
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "core/OffscreenContext.hpp"
+#include "core/TaskScheduler.hpp"
+#include "fractal/BlaTable.hpp"
+#include "fractal/FractalComputer.hpp"
+#include "fractal/ReferenceOrbit.hpp"
+#include "fractal/cpu/CpuFractalRenderer.hpp"
+#include "ui/UIState.hpp"
+
+struct BatchOptions
+{
+		std::vector<std::filesystem::path> presets;
+		std::filesystem::path outputDirectory = ".";
+		int width = 0; // 0 keeps the size stored in the preset.
+		int height = 0;
+		int scale = 1;
+		int supersample = 1;
+		ResolveFilter filter = ResolveFilter::Mitchell;
+		RenderBackend backend = RenderBackend::GPU;
+		ScreenshotFormat format = ScreenshotFormat::PNG;
+};
+
+// Renders .fracta presets to image files without a window. Startup, shader compilation and the worker pool are
+// paid once for the whole batch, and each image is encoded on a worker while the next one renders. The GPU backend
+// needs an offscreen OpenGL context; the CPU backend runs without OpenGL at all.
+class BatchRenderer
+{
+	public:
+		// Returns nullopt after printing usage for --help; throws std::invalid_argument for malformed command lines.
+		static std::optional<BatchOptions> parseArguments(int argc, char** argv);
+
+		explicit BatchRenderer(BatchOptions options);
+		~BatchRenderer();
+
+		BatchRenderer(const BatchRenderer&) = delete;
+		BatchRenderer& operator=(const BatchRenderer&) = delete;
+		BatchRenderer(BatchRenderer&&) = delete;
+		BatchRenderer& operator=(BatchRenderer&&) = delete;
+
+		// Renders every preset and returns how many of them failed to load, render or save.
+		int run();
+
+	private:
+		bool renderPreset(const std::filesystem::path& presetPath);
+		std::vector<uint8_t> renderOnCpu(const FractalState& state, int width, int height);
+		// Encodes on a worker, blocking first while too many finished images are still waiting to be written.
+		void queueWrite(const ScreenshotRequest& request, int width, int height, std::vector<uint8_t> pixels);
+		void waitForWrites(int maxPending);
+
+		BatchOptions m_options;
+
+		// Declared ahead of the scheduler so they outlive the encode tasks it drains on destruction.
+		std::mutex m_writeMutex;
+		std::condition_variable m_writeCondition;
+		int m_pendingWrites = 0;
+		int m_failedWrites = 0;
+
+		std::unique_ptr<OffscreenContext> m_context;
+		std::unique_ptr<FractalComputer> m_fractalComputer;
+
+		std::unique_ptr<TaskScheduler> m_scheduler;
+		std::unique_ptr<CpuFractalRenderer> m_cpuRenderer;
+		ReferenceOrbit m_referenceOrbit;
+		BlaTable m_blaTable;
+};
@@ -0,0 +1,295 @@
+#include "RenderThread.hpp"
+
+#include <chrono>
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#include "util/Logger.hpp"
+
+namespace
+{
+	// An idle render thread still wakes this often, so shader warm-up and exports keep moving at the UI's frame rate.
+	constexpr auto IDLE_INTERVAL = std::chrono::milliseconds(16);
+	// Longest wait for the GPU to finish the previous frame before the next one is published regardless.
+	constexpr GLuint64 FRAME_WAIT_NS = 1'000'000'000;
+}
+
+RenderedFrame::~RenderedFrame()
+{
+	if (renderedFence != nullptr)
+		glDeleteSync(renderedFence);
+	if (releasedFence != nullptr)
+		glDeleteSync(releasedFence);
+}
+
+RenderThread::RenderThread(SDL_Window* window, int width, int height) : m_window(window)
+{
+	SDL_GLContext windowContext = SDL_GL_GetCurrentContext();
+	SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+	m_context = SDL_GL_CreateContext(window);
+	SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+	// Creating a context makes it current; the render thread takes it over below.
+	SDL_GL_MakeCurrent(window, windowContext);
+	if (m_context == nullptr)
+	{
+		FRACTAL_CRITICAL("Failed to create the render thread's OpenGL context: {}", SDL_GetError());
+		throw std::runtime_error(
+			std::format("Failed to create the render thread's OpenGL context: {}", SDL_GetError()));
+	}
+
+	std::promise<void> started;
+	std::future<void> ready = started.get_future();
+	m_thread = std::thread([this, width, height, &started] { run(width, height, started); });
+	try
+	{
+		ready.get();
+	}
+	catch (...)
+	{
+		m_thread.join();
+		SDL_GL_DestroyContext(m_context);
+		throw;
+	}
+	FRACTAL_INFO("Render thread started.");
+}
+
+RenderThread::~RenderThread()
+{
+	{
+		const std::lock_guard lock(m_taskMutex);
+		m_stopping = true;
+		m_hasTasks.store(true, std::memory_order_release);
+	}
+	m_taskCondition.notify_one();
+	m_thread.join();
+	SDL_GL_DestroyContext(m_context);
+	FRACTAL_INFO("Render thread stopped after {} views ({} dropped before starting, {} cut short).",
+				 m_jobCounts.started, m_jobCounts.dropped, m_jobCounts.cancelled);
+}
+
+void RenderThread::submit(const FractalState& state)
+{
+	RenderJob& job = m_jobs.back();
+	job.state = state;
+	job.version = ++m_submittedVersion;
+	m_jobs.publish();
+	wake();
+}
+
+void RenderThread::post(std::function<void(FractalComputer&)> task)
+{
+	{
+		const std::lock_guard lock(m_taskMutex);
+		if (m_closed)
+			return;
+		m_tasks.push_back({ .run = std::move(task), .done = nullptr });
+		m_hasTasks.store(true, std::memory_order_release);
+	}
+	m_taskCondition.notify_one();
+}
+
+void RenderThread::invoke(const std::function<void(FractalComputer&)>& task)
+{
+	auto done = std::make_shared<std::promise<void>>();
+	std::future<void> finished = done->get_future();
+	{
+		const std::lock_guard lock(m_taskMutex);
+		if (m_closed)
+			throw std::runtime_error("The render thread has stopped.");
+		m_tasks.push_back({ .run = task, .done = done });
+		m_hasTasks.store(true, std::memory_order_release);
+	}
+	m_taskCondition.notify_one();
+	finished.get();
+}
+
+void RenderThread::addStep(std::function<void(FractalComputer&)> step)
+{
+	post([this, step = std::move(step)](FractalComputer&) mutable { m_steps.push_back(std::move(step)); });
+}
+
+const RenderedFrame& RenderThread::acquireFrame()
+{
+	if (m_failed.load(std::memory_order_acquire))
+		std::rethrow_exception(m_failure);
+
+	if (m_frames.hasNewer())
+	{
+		// The render thread may write over the frame shown so far once the draws already issued from it are done.
+		m_frames.front().releasedFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		glFlush();
+		m_frames.acquire();
+		glWaitSync(m_frames.front().renderedFence, 0, GL_TIMEOUT_IGNORED);
+	}
+	return m_frames.front();
+}
+
+void RenderThread::run(int width, int height, std::promise<void>& started)
+{
+	SDL_GL_MakeCurrent(m_window, m_context);
+	try
+	{
+		m_computer = std::make_unique<FractalComputer>(width, height);
+		publishFrame();
+	}
+	catch (...)
+	{
+		m_computer.reset();
+		SDL_GL_MakeCurrent(m_window, nullptr);
+		started.set_exception(std::current_exception());
+		return;
+	}
+	// The constructor returns once this is set, taking `started` with it.
+	started.set_value();
+
+	try
+	{
+		while (true)
+		{
+			bool changed = runTasks();
+			if (m_jobs.hasNewer())
+			{
+				startJob();
+				changed = true;
+			}
+			else if (m_computer->isRefining())
+			{
+				m_computer->refine(m_jobs.front().state, [this] { return isSuperseded(); });
+				changed = true;
+			}
+			else if (!changed)
+			{
+				m_computer->pollShaderWarmUp();
+			}
+			m_computer->pollScreenshots();
+			for (const auto& step : m_steps)
+				step(*m_computer);
+
+			if (changed)
+				publishFrame();
+
+			std::unique_lock lock(m_taskMutex);
+			if (m_stopping)
+				break;
+			if (!changed)
+			{
+				m_taskCondition.wait_for(lock, IDLE_INTERVAL,
+										 [this] { return m_stopping || !m_tasks.empty() || m_jobs.hasNewer(); });
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		FRACTAL_CRITICAL("Render thread failed: {}", e.what());
+		m_failure = std::current_exception();
+		m_failed.store(true, std::memory_order_release);
+	}
+
+	{
+		const std::lock_guard lock(m_taskMutex);
+		m_closed = true;
+		for (Task& task : m_tasks)
+		{
+			if (task.done)
+				task.done->set_exception(std::make_exception_ptr(std::runtime_error("The render thread has stopped.")));
+		}
+		m_tasks.clear();
+	}
+	m_computer.reset();
+	SDL_GL_MakeCurrent(m_window, nullptr);
+}
+
+bool RenderThread::runTasks()
+{
+	std::deque<Task> tasks;
+	{
+		const std::lock_guard lock(m_taskMutex);
+		tasks.swap(m_tasks);
+		if (!m_stopping)
+			m_hasTasks.store(false, std::memory_order_relaxed);
+	}
+
+	for (Task& task : tasks)
+	{
+		try
+		{
+			task.run(*m_computer);
+			if (task.done)
+				task.done->set_value();
+		}
+		catch (const std::exception& e)
+		{
+			if (task.done)
+				task.done->set_exception(std::current_exception());
+			else
+				FRACTAL_ERROR("Render thread task failed: {}", e.what());
+		}
+	}
+	return !tasks.empty();
+}
+
+void RenderThread::startJob()
+{
+	// A render still refining when a newer job arrives has been cut short at a row of tiles.
+	if (m_computer->isRefining())
+		++m_jobCounts.cancelled;
+	m_jobs.acquire();
+	const RenderJob& job = m_jobs.front();
+	m_jobCounts.dropped += job.version - m_startedVersion - 1;
+	++m_jobCounts.started;
+	m_startedVersion = job.version;
+
+	m_computer->generate(job.state, [this] { return isSuperseded(); });
+}
+
+bool RenderThread::isSuperseded() const
+{
+	return m_jobs.hasNewer() || m_hasTasks.load(std::memory_order_acquire);
+}
+
+void RenderThread::publishFrame()
+{
+	if (m_inFlightFence != nullptr)
+		glClientWaitSync(m_inFlightFence, GL_SYNC_FLUSH_COMMANDS_BIT, FRAME_WAIT_NS);
+
+	RenderedFrame& frame = m_frames.back();
+	if (frame.releasedFence != nullptr)
+	{
+		glWaitSync(frame.releasedFence, 0, GL_TIMEOUT_IGNORED);
+		glDeleteSync(frame.releasedFence);
+		frame.releasedFence = nullptr;
+	}
+	if (frame.renderedFence != nullptr)
+	{
+		glDeleteSync(frame.renderedFence);
+		frame.renderedFence = nullptr;
+	}
+
+	const Texture& source = m_computer->getTexture();
+	if (!frame.texture)
+		frame.texture = std::make_unique<Texture>(source.getWidth(), source.getHeight());
+	else if (frame.texture->getWidth() != source.getWidth() || frame.texture->getHeight() != source.getHeight())
+		frame.texture->resize(source.getWidth(), source.getHeight());
+
+	glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+	glCopyImageSubData(source.getID(), GL_TEXTURE_2D, 0, 0, 0, 0, frame.texture->getID(), GL_TEXTURE_2D, 0, 0, 0, 0,
+					   source.getWidth(), source.getHeight(), 1);
+	frame.stats = m_computer->getStats();
+	frame.stats.jobs = m_jobCounts;
+	frame.renderedFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	// The UI context can only wait on a fence that has reached the GPU.
+	glFlush();
+
+	m_inFlightFence = frame.renderedFence;
+	m_frames.publish();
+}
+
+void RenderThread::wake()
+{
+	// Taking the lock orders the notification after the render thread last checked for work, so it is never lost.
+	{
+		const std::lock_guard lock(m_taskMutex);
+	}
+	m_taskCondition.notify_one();
+}
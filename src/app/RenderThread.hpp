@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glad/gl.h>
+
+#include "core/TripleBuffer.hpp"
+#include "fractal/FractalComputer.hpp"
+#include "fractal/FractalState.hpp"
+#include "gfx/Texture.hpp"
+
+// A finished frame of the interactive view, as the UI shows it.
+struct RenderedFrame
+{
+		RenderedFrame() = default;
+		~RenderedFrame();
+
+		RenderedFrame(const RenderedFrame&) = delete;
+		RenderedFrame& operator=(const RenderedFrame&) = delete;
+		RenderedFrame(RenderedFrame&&) = delete;
+		RenderedFrame& operator=(RenderedFrame&&) = delete;
+
+		std::unique_ptr<Texture> texture;
+		RenderStats stats;
+		GLsync renderedFence = nullptr; // Signaled once the render thread's copy into texture is done.
+		GLsync releasedFence = nullptr; // Signaled once the UI's last draw from texture is done.
+};
+
+// Runs the FractalComputer on a thread of its own, with a GL context that shares objects with the window's, so a
+// slow fractal frame never holds up input handling or the UI. The UI thread submits view states as numbered jobs,
+// which the render thread picks up through a lock-free latest-value mailbox: a burst of edits costs one render of the
+// last state, and a render still in progress when a newer job arrives is abandoned at the next row of tiles.
+// Finished frames come back the same way through three textures, so the UI always shows the newest complete frame
+// and neither side waits for the other. Anything else that touches the computer runs on the render thread as a task,
+// which pauses a render in progress at the next row of tiles rather than waiting for its frame budget to run out.
+class RenderThread
+{
+	public:
+		// Creates the render context while the window's is current, and returns once the computer is set up and the
+		// first (blank) frame is published. Throws what constructing the computer threw.
+		RenderThread(SDL_Window* window, int width, int height);
+		// Drops queued tasks, destroys the computer on the render thread and joins it.
+		~RenderThread();
+
+		RenderThread(const RenderThread&) = delete;
+		RenderThread& operator=(const RenderThread&) = delete;
+		RenderThread(RenderThread&&) = delete;
+		RenderThread& operator=(RenderThread&&) = delete;
+
+		// Renders `state` once the render thread gets to it, unless a later submit() replaces it first. Meant to be
+		// called at most once per UI frame.
+		void submit(const FractalState& state);
+		// Queues a task for the render thread between two frames and returns right away; exceptions are logged.
+		void post(std::function<void(FractalComputer&)> task);
+		// Runs a task on the render thread between two frames and waits for it, rethrowing what it threw.
+		void invoke(const std::function<void(FractalComputer&)>& task);
+		// Has the render thread call `step` once per iteration of its loop from now on, for work that moves along in
+		// short non-blocking steps, like the exporters. A render in progress still goes out a row of tiles at a time.
+		void addStep(std::function<void(FractalComputer&)> step);
+
+		// Newest published frame; its texture is safe to draw from on the UI context until the next call. Rethrows
+		// the exception that stopped the render thread, if one did.
+		const RenderedFrame& acquireFrame();
+
+	private:
+		struct RenderJob
+		{
+				FractalState state;
+				uint64_t version = 0; // Counts up with every submit().
+		};
+
+		struct Task
+		{
+				std::function<void(FractalComputer&)> run;
+				std::shared_ptr<std::promise<void>> done; // Set by invoke(), which waits for it.
+		};
+
+		void run(int width, int height, std::promise<void>& started);
+		// Runs the queued tasks and returns whether there were any.
+		bool runTasks();
+		// Starts rendering the newest job, counting the ones it replaced.
+		void startJob();
+		// Whether a render in progress should stop at the next row of tiles: a newer job or a task is waiting, and a
+		// task must not sit behind the whole frame budget of a deep zoom.
+		[[nodiscard]] bool isSuperseded() const;
+		// Copies the computer's colored frame into the free slot and publishes it, after the GPU finished the
+		// frame published before, so the render thread never runs more than a frame ahead.
+		void publishFrame();
+		void wake();
+
+		SDL_Window* m_window = nullptr;
+		SDL_GLContext m_context = nullptr;
+		std::unique_ptr<FractalComputer> m_computer; // Only touched on the render thread.
+
+		TripleBuffer<RenderJob> m_jobs;
+		uint64_t m_submittedVersion = 0; // UI thread only.
+		uint64_t m_startedVersion = 0;	 // Render thread only, like m_jobCounts.
+		RenderJobCounts m_jobCounts;
+		TripleBuffer<RenderedFrame> m_frames;
+		GLsync m_inFlightFence = nullptr;
+
+		std::mutex m_taskMutex;
+		std::condition_variable m_taskCondition;
+		std::deque<Task> m_tasks;
+		bool m_stopping = false;
+		bool m_closed = false; // Set once the render thread no longer takes tasks.
+		std::atomic<bool> m_hasTasks{ false }; // Set with every task queued and on stopping, cleared by runTasks().
+		std::vector<std::function<void(FractalComputer&)>> m_steps; // Render thread only.
+
+		std::atomic<bool> m_failed{ false };
+		std::exception_ptr m_failure; // Written before m_failed is set.
+		std::thread m_thread;
+};
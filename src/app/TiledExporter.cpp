@@ -0,0 +1,207 @@
+#include "TiledExporter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "fractal/Supersampling.hpp"
+#include "fractal/ViewRegion.hpp"
+#include "util/Logger.hpp"
+
+namespace
+{
+	// Largest tile edge in output pixels.
+	constexpr int TILE_SIZE = 2048;
+	// Largest tile edge in samples. Supersampled tiles shrink to stay within it, which bounds the sample textures.
+	constexpr int MAX_TILE_SAMPLES = 4096;
+	// A band spans the whole image width, since PNG rows cannot be split; wide images get shorter bands instead.
+	constexpr size_t MAX_BAND_BYTES = size_t{ 128 } << 20;
+	constexpr int MIN_BAND_ROWS = 16;
+}
+
+TiledExporter::TiledExporter(FractalComputer& computer, const ScreenshotRequest& request, const FractalState& state)
+	: m_computer(computer), m_request(request), m_state(state),
+	  m_width(state.renderWidth * request.scale), m_height(state.renderHeight * request.scale),
+	  m_start(std::chrono::steady_clock::now())
+{
+	m_request.format = ScreenshotFormat::PNG;
+	if (m_width <= 0 || m_height <= 0)
+		throw std::runtime_error(std::format("Cannot export an image of {}x{} pixels", m_width, m_height));
+
+	m_state.renderWidth = m_width;
+	m_state.renderHeight = m_height;
+
+	const size_t rowBytes = static_cast<size_t>(m_width) * 4;
+	const int supersample = std::max(1, m_request.supersample);
+	const int tileSize = std::clamp((MAX_TILE_SAMPLES / supersample) - (2 * Supersampling::getMargin(request.filter)),
+									MIN_BAND_ROWS, TILE_SIZE);
+	m_tileWidth = std::min(m_width, tileSize);
+	m_bandHeight = std::clamp(static_cast<int>(std::min<size_t>(MAX_BAND_BYTES / rowBytes, tileSize)),
+							  std::min(MIN_BAND_ROWS, m_height), m_height);
+	m_columns = (m_width + m_tileWidth - 1) / m_tileWidth;
+	m_tileCount = m_columns * ((m_height + m_bandHeight - 1) / m_bandHeight);
+
+	m_writer = std::make_unique<PngStreamWriter>(m_request.filepath, m_width, m_height);
+	m_band.resize(rowBytes * static_cast<size_t>(getBandRows(0)));
+
+	if (m_state.backend == RenderBackend::GPU)
+	{
+		for (Slot& slot : m_slots)
+			slot.image = std::make_unique<Texture>(m_tileWidth, m_bandHeight);
+	}
+	FRACTAL_INFO("Exporting {}x{} at {}x supersampling in {} tiles of up to {}x{} to {}", m_width, m_height,
+				 supersample, m_tileCount, m_tileWidth, m_bandHeight, m_request.filepath.string());
+}
+
+TiledExporter::~TiledExporter()
+{
+	std::unique_lock lock(m_writeMutex);
+	m_writeCondition.wait(lock, [this] { return !m_isWriting; });
+
+	if (m_writeFailed || m_rowsWritten < m_height)
+	{
+		m_writer.reset();
+		std::error_code error;
+		std::filesystem::remove(m_request.filepath, error);
+		FRACTAL_WARN("Tiled export stopped after {} of {} rows; removed {}.", m_rowsWritten, m_height,
+					 m_request.filepath.string());
+		return;
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+	const double megapixels = static_cast<double>(m_width) * static_cast<double>(m_height) / 1e6;
+	FRACTAL_INFO("Tiled export saved {:.0f} megapixels to {} in {:.1f} s.", megapixels, m_request.filepath.string(),
+				 elapsed.count());
+}
+
+bool TiledExporter::advance()
+{
+	if (m_bandFull)
+		tryWriteBand();
+
+	if (m_state.backend == RenderBackend::GPU)
+	{
+		// A full band that is still waiting for the writer keeps its tiles' successors in their slots.
+		while (!m_bandFull && m_collectedTiles < m_startedTiles)
+		{
+			Slot& slot = m_slots[static_cast<size_t>(m_collectedTiles) % SLOT_COUNT];
+			if (!slot.readback.isReady())
+				break;
+			storeTile(m_collectedTiles, slot.readback.finish(), false);
+		}
+
+		if (m_startedTiles < m_tileCount && m_startedTiles - m_collectedTiles < static_cast<int>(SLOT_COUNT))
+		{
+			const TileRect rect = getTile(m_startedTiles);
+			Slot& slot = m_slots[static_cast<size_t>(m_startedTiles) % SLOT_COUNT];
+			slot.image->resize(rect.width, rect.height);
+			m_computer.renderSupersampled(getTileState(rect), m_request.supersample, m_request.filter, *slot.image);
+			slot.readback.start(*slot.image);
+			++m_startedTiles;
+		}
+	}
+	else if (!m_bandFull && m_startedTiles < m_tileCount)
+	{
+		// The CPU backend renders the tile on the worker pool right here, overlapping the previous band's write.
+		const TileRect rect = getTile(m_startedTiles);
+		storeTile(m_startedTiles++,
+				  m_computer.renderImage(getTileState(rect), rect.width, rect.height, m_request.supersample,
+										 m_request.filter),
+				  true);
+	}
+
+	std::lock_guard lock(m_writeMutex);
+	return !m_writeFailed && m_rowsWritten < m_height;
+}
+
+int TiledExporter::getRowsWritten() const
+{
+	std::lock_guard lock(m_writeMutex);
+	return m_rowsWritten;
+}
+
+TiledExporter::TileRect TiledExporter::getTile(int tile) const
+{
+	const int band = tile / m_columns;
+	const int x = (tile % m_columns) * m_tileWidth;
+	return { .x = x,
+			 .row = band * m_bandHeight,
+			 .width = std::min(m_tileWidth, m_width - x),
+			 .height = getBandRows(band) };
+}
+
+int TiledExporter::getBandRows(int band) const
+{
+	return std::min(m_bandHeight, m_height - (band * m_bandHeight));
+}
+
+FractalState TiledExporter::getTileState(const TileRect& rect) const
+{
+	// The saved image is flipped from the texture's row order, so file row r is texture row height - 1 - r.
+	const int top = m_height - rect.row - rect.height;
+	return ViewRegion::crop(m_state, rect.x, top, rect.width, rect.height);
+}
+
+void TiledExporter::storeTile(int tile, const std::vector<uint8_t>& pixels, bool bottomUp)
+{
+	const TileRect rect = getTile(tile);
+	if (!pixels.empty())
+	{
+		const size_t bandPitch = static_cast<size_t>(m_width) * 4;
+		const size_t tilePitch = static_cast<size_t>(rect.width) * 4;
+		for (int y = 0; y < rect.height; ++y)
+		{
+			const int source = bottomUp ? rect.height - 1 - y : y;
+			std::memcpy(m_band.data() + (static_cast<size_t>(y) * bandPitch) + (static_cast<size_t>(rect.x) * 4),
+						pixels.data() + (static_cast<size_t>(source) * tilePitch), tilePitch);
+		}
+	}
+	else
+	{
+		FRACTAL_ERROR("Tile {} of {} came back empty.", tile + 1, m_tileCount);
+		std::lock_guard lock(m_writeMutex);
+		m_writeFailed = true;
+	}
+
+	m_collectedTiles = tile + 1;
+	if (rect.x + rect.width == m_width)
+	{
+		m_bandFull = true;
+		tryWriteBand();
+	}
+}
+
+void TiledExporter::tryWriteBand()
+{
+	{
+		std::lock_guard lock(m_writeMutex);
+		if (m_isWriting || m_writeFailed)
+			return;
+		m_isWriting = true;
+		std::swap(m_band, m_writingBand);
+	}
+
+	const int rows = getBandRows(m_fillingBand);
+	++m_fillingBand;
+	const bool lastBand = m_fillingBand * m_bandHeight >= m_height;
+	if (!lastBand)
+		m_band.resize(static_cast<size_t>(m_width) * 4 * static_cast<size_t>(getBandRows(m_fillingBand)));
+	m_bandFull = false;
+
+	m_computer.getScheduler().submit([this, rows, lastBand]() {
+		bool written = m_writer->writeRows(m_writingBand.data(), rows);
+		if (written && lastBand)
+			written = m_writer->finish();
+
+		std::lock_guard lock(m_writeMutex);
+		m_isWriting = false;
+		m_writeFailed |= !written;
+		if (written)
+			m_rowsWritten += rows;
+		m_writeCondition.notify_all();
+	});
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "fractal/FractalComputer.hpp"
+#include "gfx/PixelReadback.hpp"
+#include "gfx/PngStreamWriter.hpp"
+#include "gfx/Texture.hpp"
+#include "ui/UIState.hpp"
+
+// Renders an export too large to hold in memory as a grid of tiles, each a sub-view of the requested view with its
+// own offset and zoom, and streams the result to a PNG one band of rows at a time. Only two bands are resident:
+// one fills up from finished tiles while the previous one is compressed on a worker, so memory stays bounded by the
+// tile and band size however large the output is. Supersampled tiles are resolved before they are read back, and
+// shrink as the factor grows so their sample grids stay small. Like AnimationExporter it never waits on the GPU;
+// advance() moves the tiles along once per render loop iteration.
+class TiledExporter
+{
+	public:
+		// The output is the state's render size times the request's scale, always written as PNG.
+		// Throws std::runtime_error when the file cannot be created.
+		TiledExporter(FractalComputer& computer, const ScreenshotRequest& request, const FractalState& state);
+		// Waits for the band being written. A file that was not finished is removed.
+		~TiledExporter();
+
+		TiledExporter(const TiledExporter&) = delete;
+		TiledExporter& operator=(const TiledExporter&) = delete;
+		TiledExporter(TiledExporter&&) = delete;
+		TiledExporter& operator=(TiledExporter&&) = delete;
+
+		// Collects finished tiles, hands full bands to the writer and starts the next tile. Returns false once the
+		// file is complete or writing it failed.
+		bool advance();
+
+		[[nodiscard]] int getHeight() const { return m_height; }
+		[[nodiscard]] int getRowsWritten() const;
+
+	private:
+		// Tiles in flight on the GPU, as in AnimationExporter.
+		static constexpr size_t SLOT_COUNT = 3;
+
+		struct Slot
+		{
+				std::unique_ptr<Texture> image;
+				PixelReadback readback;
+		};
+
+		// Tile rectangle in file rows, which run top to bottom like the saved image.
+		struct TileRect
+		{
+				int x = 0;
+				int row = 0;
+				int width = 0;
+				int height = 0;
+		};
+
+		[[nodiscard]] TileRect getTile(int tile) const;
+		[[nodiscard]] int getBandRows(int band) const;
+		[[nodiscard]] FractalState getTileState(const TileRect& rect) const;
+		// Copies a finished tile into the filling band; flipped when its rows arrive bottom-up.
+		void storeTile(int tile, const std::vector<uint8_t>& pixels, bool bottomUp);
+		// Hands the filled band to the writer unless the previous band is still being written.
+		void tryWriteBand();
+
+		FractalComputer& m_computer;
+		ScreenshotRequest m_request;
+		FractalState m_state; // Sized to the whole output.
+		int m_width = 0;
+		int m_height = 0;
+		int m_tileWidth = 0;
+		int m_bandHeight = 0;
+		int m_columns = 0;
+		int m_tileCount = 0;
+		int m_startedTiles = 0;
+		int m_collectedTiles = 0;
+		int m_fillingBand = 0;
+		bool m_bandFull = false;
+		std::vector<uint8_t> m_band;
+		std::array<Slot, SLOT_COUNT> m_slots;
+		std::chrono::steady_clock::time_point m_start;
+
+		// Shared with the write task.
+		mutable std::mutex m_writeMutex;
+		std::condition_variable m_writeCondition;
+		std::unique_ptr<PngStreamWriter> m_writer;
+		std::vector<uint8_t> m_writingBand;
+		bool m_isWriting = false;
+		bool m_writeFailed = false;
+		int m_rowsWritten = 0;
+};
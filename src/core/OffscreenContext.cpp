@@ -0,0 +1,85 @@
+#include "OffscreenContext.hpp"
+
+#include <format>
+#include <stdexcept>
+
+#include <glad/gl.h>
+
+#include "util/Logger.hpp"
+
+namespace
+{
+	constexpr auto OFFSCREEN_VIDEO_DRIVER = "offscreen";
+	// The surface is never drawn to; rendering goes to textures.
+	constexpr int SURFACE_SIZE = 16;
+}
+
+OffscreenContext::OffscreenContext()
+{
+	if (!tryCreate(OFFSCREEN_VIDEO_DRIVER) && !tryCreate(nullptr))
+	{
+		throw std::runtime_error(std::format("Failed to create an offscreen OpenGL context: {}", SDL_GetError()));
+	}
+
+	if (!gladLoaderLoadGL())
+	{
+		destroy();
+		throw std::runtime_error("Failed to initialize GLAD");
+	}
+	FRACTAL_INFO("Offscreen OpenGL context ready: {} ({})", reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+				 reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+}
+
+OffscreenContext::~OffscreenContext()
+{
+	destroy();
+}
+
+bool OffscreenContext::tryCreate(const char* videoDriver)
+{
+	if (videoDriver != nullptr)
+		SDL_SetHint(SDL_HINT_VIDEO_DRIVER, videoDriver);
+	else
+		SDL_ResetHint(SDL_HINT_VIDEO_DRIVER);
+
+	const char* driverName = videoDriver != nullptr ? videoDriver : "default";
+	if (!SDL_Init(SDL_INIT_VIDEO))
+	{
+		FRACTAL_WARN("SDL video driver '{}' unavailable: {}", driverName, SDL_GetError());
+		return false;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 6);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 0);
+
+	m_window = SDL_CreateWindow("FractaVista", SURFACE_SIZE, SURFACE_SIZE, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+	if (m_window != nullptr)
+		m_glContext = SDL_GL_CreateContext(m_window);
+
+	if (m_glContext == nullptr || !SDL_GL_MakeCurrent(m_window, m_glContext))
+	{
+		FRACTAL_WARN("No OpenGL context on SDL video driver '{}': {}", driverName, SDL_GetError());
+		destroy();
+		return false;
+	}
+
+	FRACTAL_INFO("Rendering offscreen through SDL video driver '{}'.", driverName);
+	return true;
+}
+
+void OffscreenContext::destroy()
+{
+	if (m_glContext != nullptr)
+	{
+		SDL_GL_DestroyContext(m_glContext);
+		m_glContext = nullptr;
+	}
+	if (m_window != nullptr)
+	{
+		SDL_DestroyWindow(m_window);
+		m_window = nullptr;
+	}
+	SDL_Quit();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+// OpenGL context for rendering without showing anything. It prefers SDL's offscreen video driver, which creates the
+// context through EGL and needs no display server, and falls back to a hidden window on the default driver.
+class OffscreenContext
+{
+	public:
+		// Throws std::runtime_error when no OpenGL 4.6 core context can be created.
+		OffscreenContext();
+		~OffscreenContext();
+
+		OffscreenContext(const OffscreenContext&) = delete;
+		OffscreenContext& operator=(const OffscreenContext&) = delete;
+		OffscreenContext(OffscreenContext&&) = delete;
+		OffscreenContext& operator=(OffscreenContext&&) = delete;
+
+	private:
+		bool tryCreate(const char* videoDriver);
+		void destroy();
+
+		SDL_Window* m_window = nullptr;
+		SDL_GLContext m_glContext = nullptr;
+};
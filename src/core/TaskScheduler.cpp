@@ -0,0 +1,262 @@
+#include "TaskScheduler.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+#include "util/Logger.hpp"
+
+namespace
+{
+	thread_local const TaskScheduler* t_scheduler = nullptr;
+	thread_local size_t t_workerIndex = 0;
+
+	// Logs the exception being handled, for tasks nobody waits on.
+	void logTaskFailure(size_t workerIndex)
+	{
+		try
+		{
+			throw;
+		}
+		catch (const std::exception& e)
+		{
+			FRACTAL_ERROR("Task failed on worker {}: {}", workerIndex, e.what());
+		}
+		catch (...)
+		{
+			FRACTAL_ERROR("Task failed on worker {} with an unknown exception.", workerIndex);
+		}
+	}
+}
+
+TaskScheduler::TaskScheduler(unsigned workerCount)
+{
+	if (workerCount == 0)
+	{
+		workerCount = std::thread::hardware_concurrency();
+	}
+	// Always keep at least one background thread so submitted tasks make progress on single-core machines.
+	workerCount = std::max(2U, workerCount);
+
+	m_workers.reserve(workerCount);
+	for (unsigned i = 0; i < workerCount; ++i)
+	{
+		m_workers.push_back(std::make_unique<Worker>());
+	}
+
+	// Slot 0 is reserved for the calling thread, so one fewer OS thread is needed.
+	m_threads.reserve(workerCount - 1);
+	for (size_t i = 1; i < workerCount; ++i)
+	{
+		m_threads.emplace_back([this, i]() { workerLoop(i); });
+	}
+
+	resetStats();
+	FRACTAL_INFO("Task scheduler started with {} workers.", workerCount);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	{
+		std::lock_guard lock(m_sleepMutex);
+		m_stopping = true;
+	}
+	m_sleepCondition.notify_all();
+	m_threads.clear();
+}
+
+void TaskScheduler::runIndexed(int count, IndexedFn invoke, void* context)
+{
+	if (count <= 0)
+		return;
+
+	auto batch = std::make_shared<Batch>();
+	batch->remaining.store(count, std::memory_order_relaxed);
+	const size_t workerCount = m_workers.size();
+
+	// Deal the items out round-robin so every deque starts with a similar mix of cheap and expensive work.
+	for (size_t worker = 0; worker < workerCount; ++worker)
+	{
+		Worker& target = *m_workers[worker];
+		std::lock_guard lock(target.mutex);
+		for (int index = static_cast<int>(worker); index < count; index += static_cast<int>(workerCount))
+		{
+			target.jobs.push_back({ .invoke = invoke, .context = context, .index = index, .batch = batch, .task = {} });
+		}
+	}
+	m_queuedJobs.fetch_add(count, std::memory_order_release);
+	wakeWorkers();
+
+	// A worker may help with anything while it waits. An outside thread only runs items of its own loop, so it never
+	// ends up encoding an image or writing a file before it can return.
+	const size_t self = currentWorkerIndex();
+	const Batch* only = t_scheduler == this ? nullptr : batch.get();
+	for (int left = batch->remaining.load(std::memory_order_acquire); left > 0;
+		 left = batch->remaining.load(std::memory_order_acquire))
+	{
+		if (!runOneJob(self, only))
+		{
+			// Everything is already running elsewhere; sleep until one of those items completes.
+			batch->remaining.wait(left, std::memory_order_acquire);
+		}
+	}
+
+	if (batch->error)
+		std::rethrow_exception(batch->error);
+}
+
+void TaskScheduler::submit(std::function<void()> task)
+{
+	// Slot 0 is skipped: its owner is an outside thread waiting for its own loop, which leaves other work alone.
+	const size_t worker = 1 + (m_nextSubmitWorker.fetch_add(1, std::memory_order_relaxed) % (m_workers.size() - 1));
+	push(worker, { .invoke = nullptr, .context = nullptr, .index = 0, .batch = nullptr, .task = std::move(task) });
+	wakeWorkers();
+}
+
+void TaskScheduler::push(size_t workerIndex, Job job)
+{
+	Worker& target = *m_workers[workerIndex];
+	{
+		std::lock_guard lock(target.mutex);
+		target.jobs.push_back(std::move(job));
+	}
+	m_queuedJobs.fetch_add(1, std::memory_order_release);
+}
+
+void TaskScheduler::wakeWorkers()
+{
+	// Taking the mutex orders this wake-up after any worker that is between its predicate check and wait().
+	{
+		std::lock_guard lock(m_sleepMutex);
+	}
+	m_sleepCondition.notify_all();
+}
+
+bool TaskScheduler::runOneJob(size_t workerIndex, const Batch* only)
+{
+	// Takes the first job `only` allows, searching from the back of the deque or from the front.
+	auto take = [only](std::deque<Job>& jobs, bool fromBack, Job& job) {
+		auto matches = [only](const Job& candidate) { return only == nullptr || candidate.batch.get() == only; };
+		if (fromBack)
+		{
+			const auto it = std::find_if(jobs.rbegin(), jobs.rend(), matches);
+			if (it == jobs.rend())
+				return false;
+			job = std::move(*it);
+			jobs.erase(std::next(it).base());
+			return true;
+		}
+		const auto it = std::find_if(jobs.begin(), jobs.end(), matches);
+		if (it == jobs.end())
+			return false;
+		job = std::move(*it);
+		jobs.erase(it);
+		return true;
+	};
+
+	Job job;
+	bool found = false;
+	bool stolen = false;
+
+	{
+		Worker& own = *m_workers[workerIndex];
+		std::lock_guard lock(own.mutex);
+		found = take(own.jobs, true, job);
+	}
+
+	const size_t workerCount = m_workers.size();
+	for (size_t offset = 1; !found && offset < workerCount; ++offset)
+	{
+		Worker& victim = *m_workers[(workerIndex + offset) % workerCount];
+		std::lock_guard lock(victim.mutex);
+		found = take(victim.jobs, false, job);
+		stolen = found;
+	}
+
+	if (!found)
+		return false;
+
+	m_queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+
+	const auto start = std::chrono::steady_clock::now();
+	try
+	{
+		if (job.task)
+			job.task();
+		else if (!job.batch->failed.load(std::memory_order_relaxed)) // The rest of a failed loop is skipped.
+			job.invoke(job.context, job.index);
+	}
+	catch (...)
+	{
+		// The first exception of a loop goes back to its caller; a submitted task has nobody to tell.
+		if (!job.batch)
+			logTaskFailure(workerIndex);
+		else if (!job.batch->failed.exchange(true, std::memory_order_relaxed))
+			job.batch->error = std::current_exception();
+	}
+	const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+	Worker& self = *m_workers[workerIndex];
+	self.busyNanoseconds.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+	self.tasksExecuted.fetch_add(1, std::memory_order_relaxed);
+	if (stolen)
+		self.tasksStolen.fetch_add(1, std::memory_order_relaxed);
+
+	if (job.batch && job.batch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		job.batch->remaining.notify_all();
+	}
+	return true;
+}
+
+void TaskScheduler::workerLoop(size_t workerIndex)
+{
+	t_scheduler = this;
+	t_workerIndex = workerIndex;
+
+	while (true)
+	{
+		if (runOneJob(workerIndex))
+			continue;
+
+		std::unique_lock lock(m_sleepMutex);
+		m_sleepCondition.wait(lock,
+							  [this]() { return m_stopping || m_queuedJobs.load(std::memory_order_acquire) > 0; });
+		if (m_stopping && m_queuedJobs.load(std::memory_order_acquire) <= 0)
+			return;
+	}
+}
+
+size_t TaskScheduler::currentWorkerIndex() const
+{
+	return t_scheduler == this ? t_workerIndex : 0;
+}
+
+void TaskScheduler::resetStats()
+{
+	for (const auto& worker : m_workers)
+	{
+		worker->tasksExecuted.store(0, std::memory_order_relaxed);
+		worker->tasksStolen.store(0, std::memory_order_relaxed);
+		worker->busyNanoseconds.store(0, std::memory_order_relaxed);
+	}
+	m_statsEpoch = std::chrono::steady_clock::now();
+}
+
+std::vector<WorkerStats> TaskScheduler::getWorkerStats() const
+{
+	const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_statsEpoch).count();
+
+	std::vector<WorkerStats> stats;
+	stats.reserve(m_workers.size());
+	for (const auto& worker : m_workers)
+	{
+		WorkerStats entry;
+		entry.tasksExecuted = worker->tasksExecuted.load(std::memory_order_relaxed);
+		entry.tasksStolen = worker->tasksStolen.load(std::memory_order_relaxed);
+		entry.busySeconds = static_cast<double>(worker->busyNanoseconds.load(std::memory_order_relaxed)) * 1e-9;
+		entry.utilization = wallSeconds > 0.0 ? std::min(1.0, entry.busySeconds / wallSeconds) : 0.0;
+		stats.push_back(entry);
+	}
+	return stats;
+}
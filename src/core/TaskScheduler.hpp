@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+struct WorkerStats
+{
+		uint64_t tasksExecuted = 0;
+		uint64_t tasksStolen = 0;
+		double busySeconds = 0.0;
+		double utilization = 0.0; // Busy time divided by wall time since the last resetStats().
+};
+
+// Work-stealing scheduler. Every worker owns a deque: it pops its own work from the back and, once empty,
+// steals from the front of the other deques, so expensive tiles (set interior, boundary) never leave the
+// remaining cores idle. Slot 0 belongs to whichever outside thread is waiting in parallelFor, which helps out
+// instead of blocking, but only with its own items: submitted tasks never land there, and are never picked up by a
+// caller that is only waiting for its loop.
+class TaskScheduler
+{
+	public:
+		explicit TaskScheduler(unsigned workerCount = 0);
+		~TaskScheduler();
+
+		TaskScheduler(const TaskScheduler&) = delete;
+		TaskScheduler& operator=(const TaskScheduler&) = delete;
+		TaskScheduler(TaskScheduler&&) = delete;
+		TaskScheduler& operator=(TaskScheduler&&) = delete;
+
+		// Runs fn(i) for every i in [0, count) and returns once all of them have finished. Once an item throws, the
+		// items that have not started are skipped and the first exception is rethrown here.
+		template <typename Fn>
+		void parallelFor(int count, Fn&& fn)
+		{
+			using FnType = std::remove_reference_t<Fn>;
+			runIndexed(
+				count, [](void* context, int index) { (*static_cast<FnType*>(context))(index); },
+				static_cast<void*>(std::addressof(fn)));
+		}
+
+		// Queues a fire-and-forget task. Pending tasks are drained before the scheduler is destroyed.
+		void submit(std::function<void()> task);
+
+		void resetStats();
+		[[nodiscard]] std::vector<WorkerStats> getWorkerStats() const;
+		[[nodiscard]] unsigned getWorkerCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+	private:
+		using IndexedFn = void (*)(void* context, int index);
+
+		// Items of one parallelFor; shared so the last job can still notify after the waiter left.
+		struct Batch
+		{
+				std::atomic<int> remaining{ 0 };
+				std::atomic<bool> failed{ false };
+				std::exception_ptr error; // Written by the job that set failed, read once remaining is 0.
+		};
+
+		struct Job
+		{
+				IndexedFn invoke = nullptr;
+				void* context = nullptr;
+				int index = 0;
+				std::shared_ptr<Batch> batch;
+				std::function<void()> task;
+		};
+
+		struct alignas(64) Worker
+		{
+				std::mutex mutex;
+				std::deque<Job> jobs;
+
+				std::atomic<uint64_t> tasksExecuted{ 0 };
+				std::atomic<uint64_t> tasksStolen{ 0 };
+				std::atomic<uint64_t> busyNanoseconds{ 0 };
+		};
+
+		void runIndexed(int count, IndexedFn invoke, void* context);
+		void push(size_t workerIndex, Job job);
+		void wakeWorkers();
+		// Runs one job, its own or a stolen one; with `only` set, just an item of that batch.
+		bool runOneJob(size_t workerIndex, const Batch* only = nullptr);
+		void workerLoop(size_t workerIndex);
+		[[nodiscard]] size_t currentWorkerIndex() const;
+
+		std::vector<std::unique_ptr<Worker>> m_workers;
+		std::vector<std::jthread> m_threads;
+
+		std::atomic<int64_t> m_queuedJobs{ 0 };
+		std::atomic<size_t> m_nextSubmitWorker{ 0 };
+		std::mutex m_sleepMutex;
+		std::condition_variable m_sleepCondition;
+		bool m_stopping = false;
+
+		std::chrono::steady_clock::time_point m_statsEpoch;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Hands the latest value from one producer thread to one consumer thread without locks or waiting. Each side owns
+// one of three slots and the third is in the middle: publish() swaps the producer's slot with it, and acquire()
+// swaps it with the consumer's slot when it holds something newer. Values the consumer never got to are overwritten.
+template <typename T>
+class TripleBuffer
+{
+	public:
+		// Slot the producer fills next; the consumer does not touch it.
+		[[nodiscard]] T& back() { return m_slots[m_back]; }
+		// Makes back() the latest value and hands the producer a free slot, which holds an older value.
+		void publish() { m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX_MASK; }
+
+		// True when the producer published since the last acquire(); a hint for the consumer.
+		[[nodiscard]] bool hasNewer() const { return (m_middle.load(std::memory_order_acquire) & FRESH) != 0; }
+		// Moves front() to the latest value, if there is a newer one, and returns whether it did.
+		bool acquire()
+		{
+			if (!hasNewer())
+				return false;
+			m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+			return true;
+		}
+		// Slot the consumer reads; the producer does not touch it.
+		[[nodiscard]] T& front() { return m_slots[m_front]; }
+		[[nodiscard]] const T& front() const { return m_slots[m_front]; }
+
+	private:
+		static constexpr unsigned INDEX_MASK = 3;
+		static constexpr unsigned FRESH = 4;
+
+		std::array<T, 3> m_slots{};
+		unsigned m_back = 0;
+		std::atomic<unsigned> m_middle{ 1 };
+		unsigned m_front = 2;
+};
@@ -0,0 +1,100 @@
+#include "BlaTable.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include "util/Logger.hpp"
+
+namespace
+{
+	// Relative size of the dropped dz^2 term a step may have. Smaller is more accurate but skips less.
+	constexpr double BLA_EPSILON = 1.1102230246251565e-16; // 2^-53, double rounding
+
+	glm::dvec2 complexMul(const glm::dvec2& a, const glm::dvec2& b)
+	{
+		return { a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x };
+	}
+
+	// Applies x first and then y.
+	BlaStep merge(const BlaStep& x, const BlaStep& y, double maxPixelDelta)
+	{
+		const double ax = glm::length(x.a);
+		const double bx = glm::length(x.b);
+
+		BlaStep merged;
+		merged.a = complexMul(y.a, x.a);
+		merged.b = complexMul(y.a, x.b) + y.b;
+		// NaN (from overflowed coefficients) fails the comparison and ends up as a zero radius.
+		merged.radius = std::min(x.radius, std::max(0.0, (y.radius - bx * maxPixelDelta) / ax));
+		return merged;
+	}
+}
+
+double BlaTable::maxPixelDelta(int width, int height, double zoom)
+{
+	const double aspect = static_cast<double>(width) / static_cast<double>(height);
+	return std::hypot(0.5 * aspect, 0.5) / zoom;
+}
+
+void BlaTable::clear()
+{
+	m_steps.clear();
+	m_levelCount = 0;
+}
+
+void BlaTable::build(const ReferenceOrbit& orbit, double maxPixelDelta)
+{
+	const auto start = std::chrono::steady_clock::now();
+	clear();
+
+	const auto& points = orbit.getPoints();
+	const int baseCount = orbit.getLength() - 1;
+	if (baseCount <= 0)
+		return;
+
+	m_steps.reserve(static_cast<size_t>(baseCount) * 2);
+	double maxRadius = 0.0;
+	for (int m = 1; m <= baseCount; ++m)
+	{
+		BlaStep step;
+		step.a = 2.0 * points[static_cast<size_t>(m)];
+		step.b = { 1.0, 0.0 };
+		step.radius = BLA_EPSILON * glm::length(step.a);
+		maxRadius = std::max(maxRadius, step.radius);
+		m_steps.push_back(step);
+	}
+
+	// Deltas start out at |dc|. If no single step tolerates a delta that size the table would only cost lookups,
+	// which is the case at every zoom plain perturbation already handles quickly.
+	if (maxRadius <= maxPixelDelta)
+	{
+		FRACTAL_TRACE("BLA table skipped: largest step radius {:.3e} is below the pixel delta {:.3e}.", maxRadius,
+					  maxPixelDelta);
+		clear();
+		return;
+	}
+	m_levelCount = 1;
+
+	size_t levelStart = 0;
+	int levelCount = baseCount;
+	while (levelCount >= 2)
+	{
+		const int nextCount = levelCount / 2;
+		const size_t nextStart = m_steps.size();
+		for (int j = 0; j < nextCount; ++j)
+		{
+			const size_t first = levelStart + static_cast<size_t>(2 * j);
+			const BlaStep merged = merge(m_steps[first], m_steps[first + 1], maxPixelDelta);
+			m_steps.push_back(merged);
+		}
+		levelStart = nextStart;
+		levelCount = nextCount;
+		++m_levelCount;
+	}
+
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	FRACTAL_TRACE("BLA table: {} entries in {} levels in {:.1f} ms.", m_steps.size(), m_levelCount, elapsed.count());
+}
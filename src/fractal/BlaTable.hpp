@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "ReferenceOrbit.hpp"
+
+// One bilinear approximation: dz_{m+l} = a * dz_m + b * dc, valid while |dz_m| < radius. Laid out like the
+// std430 BlaStep struct in Perturbation.glsl (48-byte stride).
+struct alignas(16) BlaStep
+{
+		glm::dvec2 a{ 0.0 };
+		glm::dvec2 b{ 0.0 };
+		double radius = 0.0;
+};
+static_assert(sizeof(BlaStep) == 48, "BlaStep must match the std430 layout in Perturbation.glsl");
+
+// Bilinear approximation table for Mandelbrot perturbation. Level 0 holds the single step from every reference
+// index m >= 1; each higher level merges adjacent pairs of the level below, so level k entry j skips 2^k
+// iterations starting at index 1 + j * 2^k. Level k has floor(count(k-1) / 2) entries and level 0 has
+// referenceLength - 1, which lets the kernels find any entry without a separate offset table.
+class BlaTable
+{
+	public:
+		// maxPixelDelta is the largest |dc| in the view; merged radii shrink by it to stay valid for every pixel.
+		void build(const ReferenceOrbit& orbit, double maxPixelDelta);
+		void clear();
+
+		// Only the Mandelbrot recurrence has a table; the other perturbation fractals iterate every step.
+		static bool supports(FractalType type) { return type == FractalType::Mandelbrot; }
+		// Largest |dc| in a width x height view: the distance from the center to a corner.
+		static double maxPixelDelta(int width, int height, double zoom);
+
+		[[nodiscard]] const std::vector<BlaStep>& getSteps() const { return m_steps; }
+		[[nodiscard]] int getLevelCount() const { return m_levelCount; }
+		[[nodiscard]] bool isEmpty() const { return m_steps.empty(); }
+
+	private:
+		std::vector<BlaStep> m_steps;
+		int m_levelCount = 0;
+};
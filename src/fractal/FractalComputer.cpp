@@ -1,224 +1,1027 @@
 #include "FractalComputer.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
-#include <span>
+#include <exception>
+#include <format>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string_view>
 #include <vector>
 
-#include <SDL3/SDL.h>
-#include <SDL3_image/SDL_image.h>
-
 #include "FractalDefinition.hpp"
+#include "PaletteLut.hpp"
+#include "Supersampling.hpp"
+#include "gfx/ImageExport.hpp"
 #include "util/FileUtils.hpp"
 #include "util/Logger.hpp"
 
-// UBO data structure for color palette, matching std140 layout
-struct alignas(16) ColorStopUBOData
+namespace
 {
-		glm::vec3 Color;
-		float Position;
-};
+	// Workgroup side of the color and resolve shaders; MainShader.glsl takes the shape its KernelTuner picked.
+	constexpr int WORK_GROUP_SIZE = 16;
+	// The first progressive pass samples one pixel in up to 64x64, as coarse as the frame budget needs; each
+	// following pass halves the stride.
+	constexpr int MAX_SAMPLE_STRIDE = 64;
+	// GPU time the interactive view may take per frame, leaving the rest of a 60 Hz frame to coloring and the UI.
+	constexpr double FRAME_GPU_BUDGET_MS = 8.0;
+	// Passes go out in tiles of this many samples along each side, in row order.
+	constexpr int TILE_SAMPLES = 64;
+	// Cost assumed until the first timer query comes back, and the weight of each new measurement after that.
+	constexpr double INITIAL_NANOSECONDS_PER_SAMPLE = 10.0;
+	constexpr double SAMPLE_COST_SMOOTHING = 0.5;
+	// A refining pass skips the quarter of its samples that the pass before already took.
+	constexpr double REFINED_SAMPLE_SHARE = 0.75;
+	// Workgroups launched in persistent-thread mode: enough to keep a large GPU occupied, while those that find the
+	// queue empty exit right away.
+	constexpr int PERSISTENT_WORKGROUPS = 1024;
+	// How far from a whole number of pixels a pan may be and still shift the previous frame.
+	constexpr double PAN_SNAP_TOLERANCE = 1e-3;
+	constexpr auto MAIN_SHADER_PATH = "assets/shaders/MainShader.glsl";
+	constexpr auto COLOR_SHADER_PATH = "assets/shaders/ColorShader.glsl";
+	constexpr auto RESOLVE_SHADER_PATH = "assets/shaders/ResolveShader.glsl";
+	constexpr auto SHADER_CACHE_DIRECTORY = "shader_cache";
+	constexpr auto KERNEL_SHAPES_FILE = "kernel_shapes.json";
+	// Kernel shapes are timed on the view that first showed the fractal, at this size and iteration cap, with the
+	// fp64 kernel most views between the shallow and the deep ones render with.
+	constexpr int TUNING_SIZE = 1024;
+	constexpr int TUNING_MAX_ITERATIONS = 1024;
+	constexpr KernelPrecision TUNING_PRECISION = KernelPrecision::Double;
+	constexpr GLuint PALETTE_TEXTURE_UNIT = 0;
+	constexpr GLuint RESOLVE_SOURCE_UNIT = 1;
+	constexpr GLuint REFERENCE_ORBIT_BINDING = 1;
+	constexpr GLuint BLA_TABLE_BINDING = 2;
+	// The iteration-skipping check renders at 1/VALIDATION_DOWNSCALE of the view size, since it iterates twice.
+	constexpr int VALIDATION_DOWNSCALE = 4;
+
+	// Pixel spacings, relative to the magnitude of the center, below which adjacent pixels are only a few hundred
+	// ulps apart and the view starts to quantize in fp32 and fp64 respectively. Past the fp64 limit fractals with a
+	// reference orbit switch to perturbation and the others to double-double, which holds out to about 1e-29
+	// before quantizing in turn.
+	constexpr double FLOAT_RELATIVE_SPACING = 1e-5;
+	constexpr double DOUBLE_RELATIVE_SPACING = 1e-13;
+	// A view only drops back to a cheaper tier once its spacing is this far above that tier's limit, so hovering
+	// around a threshold does not flip kernels (and rebuild reference orbits) every frame.
+	constexpr double PRECISION_HYSTERESIS = 2.0;
+
+	// Every tier selectPrecision() can ask for.
+	std::vector<KernelPrecision> getPrecisions(FractalType type)
+	{
+		return { KernelPrecision::Float, KernelPrecision::Double,
+				 ReferenceOrbit::supports(type) ? KernelPrecision::Perturbation : KernelPrecision::DoubleDouble };
+	}
 
-struct PaletteUBOData
+	// Every permutation selectPrecision() can ask for, in the shape each fractal is tuned to.
+	std::vector<ShaderVariant> allShaderVariants(const KernelTuner& tuner)
+	{
+		std::vector<ShaderVariant> variants;
+		for (const auto& [type, definition] : FractalDefinitions)
+		{
+			for (const KernelPrecision precision : getPrecisions(type))
+				variants.push_back({ .type = type, .precision = precision, .shape = tuner.getShape(type) });
+		}
+		return variants;
+	}
+
+}
+
+KernelPrecision selectPrecision(const FractalState& state, int height, KernelPrecision current)
 {
-		int NumStops;
-		int Padding[3]; // Explicit padding for std140
-		ColorStopUBOData Stops[MAX_PALETTE_STOPS];
-};
+	const double pixelSpacing = 1.0 / (state.zoom * static_cast<double>(height));
+	const glm::dvec2 center = state.offset.toDouble();
+	const double magnitude = std::max({ 1.0, std::abs(center.x), std::abs(center.y) });
+	const double relativeSpacing = pixelSpacing / magnitude;
+
+	auto fits = [&](KernelPrecision tier, double limit) {
+		return relativeSpacing >= (current > tier ? limit * PRECISION_HYSTERESIS : limit);
+	};
+	if (fits(KernelPrecision::Float, FLOAT_RELATIVE_SPACING))
+		return KernelPrecision::Float;
+	if (fits(KernelPrecision::Double, DOUBLE_RELATIVE_SPACING))
+		return KernelPrecision::Double;
+
+	return ReferenceOrbit::supports(state.type) ? KernelPrecision::Perturbation : KernelPrecision::DoubleDouble;
+}
 
 FractalComputer::FractalComputer(int width, int height) : m_width(width), m_height(height)
 {
 	m_texture = std::make_unique<Texture>(width, height);
+	m_iterationTexture = std::make_unique<Texture>(width, height, GL_R32F);
+	m_panIterationTexture = std::make_unique<Texture>(width, height, GL_R32F);
+	m_scheduler = std::make_unique<TaskScheduler>();
+	m_cpuRenderer = std::make_unique<CpuFractalRenderer>(*m_scheduler);
 
-	glGenBuffers(1, &m_paletteUBO);
-	glBindBuffer(GL_UNIFORM_BUFFER, m_paletteUBO);
-	glBufferData(GL_UNIFORM_BUFFER, sizeof(PaletteUBOData), nullptr, GL_DYNAMIC_DRAW);
-	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glGenTextures(1, &m_paletteTexture);
+	glBindTexture(GL_TEXTURE_1D, m_paletteTexture);
+	glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_1D, 0);
 
-	glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_paletteUBO);
+	warmUpShaders();
+
+	glGenBuffers(1, &m_referenceSSBO);
+	glGenBuffers(1, &m_blaSSBO);
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &m_maxTextureSize);
+	m_tileQueue.resize(width, height);
 
 	FRACTAL_INFO("FractalComputer initialized with texture size {}x{}.", width, height);
 }
 
 FractalComputer::~FractalComputer()
 {
-	if (m_paletteUBO != 0)
+	// Screenshots taken just before shutting down are still written; the scheduler drains their encodes.
+	for (PendingScreenshot& screenshot : m_pendingScreenshots)
+		encodeScreenshot(screenshot);
+
+	if (m_paletteTexture != 0)
 	{
-		glDeleteBuffers(1, &m_paletteUBO);
+		glDeleteTextures(1, &m_paletteTexture);
+	}
+	if (m_referenceSSBO != 0)
+	{
+		glDeleteBuffers(1, &m_referenceSSBO);
+	}
+	if (m_blaSSBO != 0)
+	{
+		glDeleteBuffers(1, &m_blaSSBO);
 	}
 }
 
-void FractalComputer::updatePaletteUBO(const ColoringParams& coloring)
+void FractalComputer::updatePaletteTexture(const std::vector<ColorStop>& palette)
 {
-	PaletteUBOData uboData{};
-	uboData.NumStops = std::min(static_cast<int>(coloring.palette.size()), MAX_PALETTE_STOPS);
+	if (m_paletteUploaded && palette == m_bakedPalette)
+		return;
+
+	const std::vector<glm::vec3> lut = PaletteLut::bake(palette);
+	glBindTexture(GL_TEXTURE_1D, m_paletteTexture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage1D(GL_TEXTURE_1D, 0, GL_RGB32F, static_cast<GLsizei>(lut.size()), 0, GL_RGB, GL_FLOAT, lut.data());
+	glBindTexture(GL_TEXTURE_1D, 0);
+
+	m_bakedPalette = palette;
+	m_paletteUploaded = true;
+}
+
+void FractalComputer::warmUpShaders()
+{
+	m_parallelCompile = Shader::enableParallelCompile();
+	m_programCache = std::make_unique<ShaderCache>(FileUtils::getUserDataPath(SHADER_CACHE_DIRECTORY));
+	m_warmUpStart = std::chrono::steady_clock::now();
+	m_kernelTuner
+		= std::make_unique<KernelTuner>(FileUtils::getUserDataPath(SHADER_CACHE_DIRECTORY) / KERNEL_SHAPES_FILE);
+
+	loadShader(COLOR_SHADER_PATH, m_colorShader);
+	loadShader(RESOLVE_SHADER_PATH, m_resolveShader);
+
+	const std::vector<ShaderVariant> variants = allShaderVariants(*m_kernelTuner);
+	for (const ShaderVariant& variant : variants)
+		startShader(variant);
+
+	m_warmUpCompiles = m_compilingSources.size();
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_warmUpStart;
+	FRACTAL_INFO("Shader warm-up: {} of {} variants loaded from the program cache in {:.1f} ms, {} to compile ({}).",
+				 variants.size() - m_warmUpCompiles, variants.size(), elapsed.count(), m_warmUpCompiles,
+				 m_parallelCompile ? "in parallel" : "one per idle frame");
+	FRACTAL_TRACE("Shader warm-up: preprocessing {} sources took {:.2f} ms.", variants.size() + 2,
+				  std::chrono::duration<double, std::milli>(m_preprocessTime).count());
+}
+
+PreprocessedShader FractalComputer::preprocess(std::string_view path, const std::vector<std::string>& defines)
+{
+	const auto start = std::chrono::steady_clock::now();
+	PreprocessedShader source = m_preprocessor.process(FileUtils::getAbsolutePath(path), defines);
+	m_preprocessTime += std::chrono::steady_clock::now() - start;
+	return source;
+}
 
-	for (int i = 0; i < uboData.NumStops; ++i)
+void FractalComputer::loadShader(std::string_view path, Shader& shader)
+{
+	const PreprocessedShader source = preprocess(path);
+	if (!m_programCache->load(source.source, shader))
 	{
-		uboData.Stops[i].Color = coloring.palette[i].color;
-		uboData.Stops[i].Position = coloring.palette[i].position;
+		shader.beginCompile(source);
+		shader.finishCompile();
+		m_programCache->store(source.source, shader);
 	}
+}
+
+void FractalComputer::startShader(const ShaderVariant& variant)
+{
+	const auto& def = FractalDefinitions.at(variant.type);
+
+	std::vector<std::string> defines = { std::string(def.shaderDefine) };
+	if (variant.precision == KernelPrecision::Float)
+		defines.emplace_back(SINGLE_PRECISION_SHADER_DEFINE);
+	else if (variant.precision == KernelPrecision::DoubleDouble)
+		defines.emplace_back(DOUBLE_DOUBLE_SHADER_DEFINE);
+	else if (variant.precision == KernelPrecision::Perturbation)
+		defines.emplace_back(PERTURBATION_SHADER_DEFINE);
+	const KernelShape& shape = variant.shape;
+	defines.push_back(std::format("WORK_GROUP_WIDTH {}", shape.groupWidth));
+	defines.push_back(std::format("WORK_GROUP_HEIGHT {}", shape.groupHeight));
+	defines.push_back(std::format("SAMPLES_X {}", shape.samplesX));
+	defines.push_back(std::format("SAMPLES_Y {}", shape.samplesY));
 
-	glBindBuffer(GL_UNIFORM_BUFFER, m_paletteUBO);
-	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(PaletteUBOData), &uboData);
-	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	PreprocessedShader preprocessed = preprocess(MAIN_SHADER_PATH, defines);
+	auto shader = std::make_unique<Shader>();
+	if (!m_programCache->load(preprocessed.source, *shader))
+	{
+		FRACTAL_INFO("Compiling {} shader for '{}' ({}x{} workgroups, {}x{} samples per invocation)...",
+					 getPrecisionName(variant.precision), def.name, shape.groupWidth, shape.groupHeight, shape.samplesX,
+					 shape.samplesY);
+		shader->beginCompile(preprocessed);
+		m_compilingSources[variant] = std::move(preprocessed.source);
+	}
+	m_shaderCache[variant] = std::move(shader);
 }
 
-Shader& FractalComputer::getOrCreateShader(FractalType type)
+void FractalComputer::finishShader(const ShaderVariant& variant)
 {
-	if (!m_shaderCache.contains(type))
+	const auto pending = m_compilingSources.find(variant);
+	if (pending == m_compilingSources.end())
+		return;
+
+	Shader& shader = *m_shaderCache.at(variant);
+	try
 	{
-		const auto& def = FractalDefinitions.at(type);
-		FRACTAL_INFO("Compiling shader for '{}'...", def.name);
+		shader.finishCompile();
+	}
+	catch (...)
+	{
+		// Forget the variant so that the next request compiles it again and reports the error where it is used.
+		m_shaderCache.erase(variant);
+		m_compilingSources.erase(pending);
+		throw;
+	}
+	m_programCache->store(pending->second, shader);
+	m_compilingSources.erase(pending);
 
-		auto shader = std::make_unique<Shader>();
-		auto shaderPath = FileUtils::getAbsolutePath("assets/shaders/MainShader.glsl");
-		shader->compileFromPath(shaderPath, { std::string(def.shaderDefine) });
+	if (m_compilingSources.empty() && m_warmUpCompiles > 0)
+	{
+		const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_warmUpStart;
+		FRACTAL_INFO("Shader warm-up finished: compiled {} variants in {:.1f} ms.", m_warmUpCompiles, elapsed.count());
+		m_warmUpCompiles = 0;
+	}
+}
 
-		shader->use();
-		shader->bindUBO("Palette", 0);
+void FractalComputer::pollShaderWarmUp()
+{
+	for (auto it = m_compilingSources.begin(); it != m_compilingSources.end();)
+	{
+		const ShaderVariant variant = (it++)->first;
+		if (!m_shaderCache.at(variant)->isReady())
+			continue;
 
-		m_shaderCache[type] = std::move(shader);
+		try
+		{
+			finishShader(variant);
+		}
+		catch (const std::exception& e)
+		{
+			FRACTAL_ERROR("Background shader compile failed: {}", e.what());
+		}
+
+		// Without parallel compilation finishing blocks, so each idle frame takes on only one variant.
+		if (!m_parallelCompile)
+			break;
 	}
-	return *m_shaderCache.at(type);
+
+	advanceKernelTuning();
 }
 
-void FractalComputer::onResize(int newWidth, int newHeight)
+ShaderVariant FractalComputer::selectVariant(FractalType type, KernelPrecision precision) const
 {
-	if (m_width == newWidth && m_height == newHeight)
-		return;
-	if (newWidth <= 0 || newHeight <= 0)
+	const ShaderVariant variant = { .type = type, .precision = precision, .shape = m_kernelTuner->getShape(type) };
+	const ShaderVariant fallback = { .type = type, .precision = precision, .shape = KernelTuner::CANDIDATES.front() };
+	const bool compiling = m_compilingSources.contains(variant) && !m_shaderCache.at(variant)->isReady();
+	if (compiling && m_shaderCache.contains(fallback) && !m_compilingSources.contains(fallback))
+		return fallback;
+	return variant;
+}
+
+void FractalComputer::startKernelTuning(const FractalState& state)
+{
+	if (!m_kernelTuner->start(state.type))
 		return;
 
-	m_width = newWidth;
-	m_height = newHeight;
-	m_texture->resize(newWidth, newHeight);
-	FRACTAL_INFO("Resized fractal texture to {}x{}.", newWidth, newHeight);
+	FRACTAL_INFO("Tuning the kernel shape of '{}' in idle frames ({} candidates).",
+				 FractalDefinitions.at(state.type).name, KernelTuner::CANDIDATES.size());
+	m_tuningView = state;
+	m_tuningView->persistentThreads = false;
+	m_tuningView->maxIterations = std::min(state.maxIterations, TUNING_MAX_ITERATIONS);
+	m_tuningTexture = std::make_unique<Texture>(TUNING_SIZE, TUNING_SIZE, GL_R32F);
+	for (const KernelShape& shape : KernelTuner::CANDIDATES)
+	{
+		const ShaderVariant variant = { .type = state.type, .precision = TUNING_PRECISION, .shape = shape };
+		if (!m_shaderCache.contains(variant))
+			startShader(variant);
+	}
 }
 
-void FractalComputer::generate(const FractalState& state)
+void FractalComputer::advanceKernelTuning()
 {
-	onResize(state.renderWidth, state.renderHeight);
+	const std::optional<FractalType> type = m_kernelTuner->getTuningType();
+	if (!type)
+		return;
 
-	Shader& shader = getOrCreateShader(state.type);
-	shader.use();
+	std::optional<KernelShape> winner;
+	for (const GpuTimer::Measurement& measurement : m_tuningTimer.collect())
+		winner = m_kernelTuner->record(static_cast<int>(measurement.work), measurement.milliseconds);
 
-	updatePaletteUBO(state.coloring);
-	m_texture->bindImage(0);
+	if (const std::optional<int> candidate = m_kernelTuner->getNextRun(); candidate && !winner)
+	{
+		const ShaderVariant variant
+			= { .type = *type, .precision = TUNING_PRECISION, .shape = KernelTuner::CANDIDATES[*candidate] };
+		if (!m_shaderCache.contains(variant))
+		{
+			// The candidate failed to compile; an endless time rules it out.
+			m_kernelTuner->markRunStarted();
+			winner = m_kernelTuner->record(*candidate, std::numeric_limits<double>::infinity());
+		}
+		else if (!m_compilingSources.contains(variant) && m_tuningTimer.begin())
+		{
+			dispatchVariant(variant, *m_tuningView, nullptr, nullptr, *m_tuningTexture, TUNING_SIZE, TUNING_SIZE);
+			m_tuningTimer.end(static_cast<double>(*candidate));
+			m_kernelTuner->markRunStarted();
+		}
+	}
+	if (!winner)
+		return;
 
-	shader.setVec2("fullResolution", glm::dvec2{ static_cast<double>(m_width), static_cast<double>(m_height) });
-	shader.setVec2("offset", state.offset);
+	// The losing candidates go; the winner's tiers compile in the background while the default shape fills in.
+	std::erase_if(m_shaderCache, [&](const auto& entry) {
+		const ShaderVariant& variant = entry.first;
+		return variant.type == *type && variant.shape != *winner && variant.shape != KernelTuner::CANDIDATES.front()
+			   && !m_compilingSources.contains(variant);
+	});
+	for (const KernelPrecision precision : getPrecisions(*type))
+	{
+		const ShaderVariant variant = { .type = *type, .precision = precision, .shape = *winner };
+		if (!m_shaderCache.contains(variant))
+			startShader(variant);
+	}
+	m_tuningView.reset();
+	m_tuningTexture.reset();
+}
+
+void FractalComputer::setViewUniforms(const Shader& shader, const FractalState& state, int width, int height) const
+{
+	shader.setVec2("fullResolution", glm::dvec2{ static_cast<double>(width), static_cast<double>(height) });
+	const glm::dvec2 offset = state.offset.toDouble();
+	shader.setVec2("offset", offset);
+	// What the rounded offset dropped, for the double-double kernels.
+	const int limbs = state.offset.x.getFractionLimbs();
+	shader.setVec2("offsetLow", glm::dvec2{ (state.offset.x - BigFixed(offset.x, limbs)).toDouble(),
+											 (state.offset.y - BigFixed(offset.y, limbs)).toDouble() });
 	shader.setDouble("zoom", state.zoom);
 	shader.setInt("maxIterations", state.maxIterations);
 	shader.setBool("useSmoothing", state.coloring.useSmoothing);
-	shader.setDouble("paletteFrequency", state.coloring.paletteFrequency);
 
 	if (state.type == FractalType::Julia)
 	{
 		shader.setVec2("juliaC", state.specificParams.juliaConstant);
 	}
+}
+
+const ReferenceOrbit* FractalComputer::prepareReferenceOrbit(const FractalState& state, KernelPrecision precision,
+															  int height)
+{
+	if (precision != KernelPrecision::Perturbation)
+		return nullptr;
+
+	if (m_referenceOrbit.update(state.type, state.offset.x, state.offset.y, state.zoom, height, state.maxIterations))
+	{
+		m_referenceUploaded = false;
+		m_blaStale = true;
+	}
+	return &m_referenceOrbit;
+}
+
+const BlaTable* FractalComputer::prepareBlaTable(const FractalState& state, const ReferenceOrbit* reference, int width,
+												 int height)
+{
+	if (reference == nullptr || !BlaTable::supports(state.type))
+		return nullptr;
+
+	const double maxPixelDelta = BlaTable::maxPixelDelta(width, height, state.zoom);
+	if (m_blaStale || maxPixelDelta != m_blaPixelDelta)
+	{
+		m_blaTable.build(*reference, maxPixelDelta);
+		m_blaPixelDelta = maxPixelDelta;
+		m_blaStale = false;
+		m_blaUploaded = false;
+	}
+	return m_blaTable.isEmpty() ? nullptr : &m_blaTable;
+}
+
+void FractalComputer::onResize(int newWidth, int newHeight)
+{
+	if (m_width == newWidth && m_height == newHeight)
+		return;
+	if (newWidth <= 0 || newHeight <= 0)
+		return;
 
-	const int groupSize = 16;
-	glDispatchCompute((m_width + groupSize - 1) / groupSize, (m_height + groupSize - 1) / groupSize, 1);
+	m_width = newWidth;
+	m_height = newHeight;
+	m_texture->resize(newWidth, newHeight);
+	m_iterationTexture->resize(newWidth, newHeight);
+	m_panIterationTexture->resize(newWidth, newHeight);
+	m_tileQueue.resize(newWidth, newHeight);
+	m_renderedView.reset();
+	m_displayedView.reset();
+	FRACTAL_INFO("Resized fractal texture to {}x{}.", newWidth, newHeight);
+}
+
+void FractalComputer::generateOnCpu(const FractalState& state, const ReferenceOrbit* reference, const BlaTable* bla)
+{
+	m_cpuRenderer->render(state, m_width, m_height, m_cpuPixels, reference, bla);
+	m_texture->upload(m_cpuPixels.data());
+
+	const CpuRenderStats& cpuStats = m_cpuRenderer->getLastStats();
+	m_stats = RenderStats{};
+	m_stats.backend = RenderBackend::CPU;
+	m_stats.cpuIsa = m_cpuRenderer->getIsaName();
+	m_stats.milliseconds = cpuStats.milliseconds;
+	m_stats.megapixelsPerSecond = cpuStats.megapixelsPerSecond;
+	m_stats.filledPixelRatio = cpuStats.filledPixelRatio;
+	m_stats.workers = cpuStats.workers;
+}
+
+void FractalComputer::colorize(const ColoringParams& coloring, Texture& iterations, Texture& target)
+{
+	updatePaletteTexture(coloring.palette);
+	m_colorShader.use();
+	m_colorShader.setDouble("paletteFrequency", coloring.paletteFrequency);
+	glActiveTexture(GL_TEXTURE0 + PALETTE_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_1D, m_paletteTexture);
+	iterations.bindImage(0, GL_READ_ONLY);
+	target.bindImage(1);
+
+	glDispatchCompute((target.getWidth() + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE,
+					  (target.getHeight() + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE, 1);
 	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
 }
 
-void FractalComputer::saveScreenshot(const ScreenshotRequest& request, const FractalState& state)
+void FractalComputer::resolveSamples(const Texture& samples, int factor, ResolveFilter filter, Texture& target)
+{
+	const std::vector<float> weights = Supersampling::getWeights(filter, factor);
+	m_resolveShader.use();
+	m_resolveShader.setInt("factor", factor);
+	m_resolveShader.setInt("tapCount", static_cast<int>(weights.size()));
+	m_resolveShader.setFloats("weights", weights);
+
+	// Across the rows into a scratch image as wide as the output, then down its columns into the target. The
+	// scratch texture is released once the commands using it have run.
+	Texture rows(target.getWidth(), samples.getHeight(), GL_RGBA16F);
+	auto filterAxis = [this](int axis, const Texture& source, Texture& destination) {
+		m_resolveShader.setInt("axis", axis);
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+		source.bind(RESOLVE_SOURCE_UNIT);
+		destination.bindImage(0);
+		glDispatchCompute((destination.getWidth() + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE,
+						  (destination.getHeight() + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE, 1);
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	};
+	filterAxis(0, samples, rows);
+	filterAxis(1, rows, target);
+}
+
+bool FractalComputer::onlyColoringChanged(const FractalState& state) const
 {
-	FRACTAL_INFO("Taking screenshot... Supersample: {}x, Path: {}", request.supersample, request.filepath.string());
+	if (!m_renderedView)
+		return false;
 
-	const int ssWidth = state.renderWidth * request.supersample;
-	const int ssHeight = state.renderHeight * request.supersample;
+	FractalState recolored = *m_renderedView;
+	recolored.coloring.palette = state.coloring.palette;
+	recolored.coloring.paletteFrequency = state.coloring.paletteFrequency;
+	recolored.needsUpdate = state.needsUpdate;
+	return recolored == state;
+}
 
-	if (ssWidth <= 0 || ssHeight <= 0)
+bool FractalComputer::recolor(const FractalState& state)
+{
+	if (state.backend == RenderBackend::CPU)
 	{
-		FRACTAL_ERROR("Cannot save screenshot with invalid dimensions ({}x{}).", ssWidth, ssHeight);
+		if (!m_cpuRenderer->recolor(state.coloring, m_width, m_height, m_cpuPixels))
+			return false;
+		m_texture->upload(m_cpuPixels.data());
+		m_stats.milliseconds = m_cpuRenderer->getLastStats().milliseconds;
+	}
+	else
+	{
+		colorize(state.coloring, *m_iterationTexture, *m_texture);
+	}
+	m_renderedView = state;
+	return true;
+}
+
+void FractalComputer::generate(const FractalState& state, const std::function<bool()>& isSuperseded)
+{
+	onResize(state.renderWidth, state.renderHeight);
+
+	// Palette edits reuse the iterations already computed; any other change renders the view again.
+	if (onlyColoringChanged(state) && recolor(state))
 		return;
+
+	m_precision = selectPrecision(state, m_height, m_precision);
+	const ReferenceOrbit* reference = prepareReferenceOrbit(state, m_precision, m_height);
+	const BlaTable* bla = state.useIterationSkipping ? prepareBlaTable(state, reference, m_width, m_height) : nullptr;
+
+	if (state.backend == RenderBackend::CPU)
+	{
+		generateOnCpu(state, reference, bla);
+		m_refineStride = 0;
+		m_displayedView.reset();
 	}
+	else
+	{
+		startKernelTuning(state);
+		if (const auto shift = findPanShift(state))
+		{
+			reprojectPan(state, reference, bla, *shift);
+			m_refineStride = 0;
+		}
+		else
+		{
+			m_refineStride = chooseFirstStride(state.progressiveRendering);
+			m_nextTile = 0;
+			m_refinesCoarserPass = false;
+			dispatchWithinBudget(state, reference, bla, isSuperseded);
+		}
+		colorize(state.coloring, *m_iterationTexture, *m_texture);
+		m_displayedView = (m_refineStride == 0) ? std::optional(state) : std::nullopt;
+		m_displayedPrecision = m_precision;
+		m_stats = RenderStats{};
+		m_stats.precision = m_precision;
+		m_stats.gpuFrameMilliseconds = m_gpuFrameMilliseconds;
+	}
+	m_renderedView = state;
+	m_stats.skippingReport = m_skippingReport;
+	m_stats.schedulingReport = m_schedulingReport;
 
-	Texture ssTexture(ssWidth, ssHeight);
-	Shader& shader = getOrCreateShader(state.type);
+	if (reference != nullptr)
+	{
+		m_stats.precision = KernelPrecision::Perturbation;
+		m_stats.referenceIterations = reference->getLength();
+		m_stats.referencePrecisionBits = reference->getPrecisionBits();
+		m_stats.iterationSkipping = bla != nullptr;
+	}
+}
 
-	shader.use();
-	updatePaletteUBO(state.coloring);
-	ssTexture.bindImage(0);
+void FractalComputer::refine(const FractalState& state, const std::function<bool()>& isSuperseded)
+{
+	if (m_refineStride == 0)
+		return;
 
-	shader.setVec2("fullResolution", glm::dvec2{ static_cast<double>(ssWidth), static_cast<double>(ssHeight) });
-	shader.setVec2("offset", state.offset);
-	shader.setDouble("zoom", state.zoom);
-	shader.setInt("maxIterations", state.maxIterations);
-	shader.setBool("useSmoothing", state.coloring.useSmoothing);
-	shader.setDouble("paletteFrequency", state.coloring.paletteFrequency);
+	// Same tier as the first pass; the orbit and table are cached, so this only looks them up.
+	const ReferenceOrbit* reference = prepareReferenceOrbit(state, m_precision, m_height);
+	const BlaTable* bla = state.useIterationSkipping ? prepareBlaTable(state, reference, m_width, m_height) : nullptr;
+	dispatchWithinBudget(state, reference, bla, isSuperseded);
+	colorize(state.coloring, *m_iterationTexture, *m_texture);
+	m_stats.gpuFrameMilliseconds = m_gpuFrameMilliseconds;
+	if (m_refineStride == 0)
+		m_displayedView = state;
+}
 
-	if (state.type == FractalType::Julia)
+int FractalComputer::chooseFirstStride(bool progressive) const
+{
+	if (!progressive)
+		return 1;
+
+	const double nanosecondsPerSample
+		= m_nanosecondsPerSample > 0.0 ? m_nanosecondsPerSample : INITIAL_NANOSECONDS_PER_SAMPLE;
+	const double budgetSamples = FRAME_GPU_BUDGET_MS * 1e6 / nanosecondsPerSample;
+	int stride = 1;
+	while (stride < MAX_SAMPLE_STRIDE)
 	{
-		shader.setVec2("juliaC", state.specificParams.juliaConstant);
+		const double samples = static_cast<double>((m_width + stride - 1) / stride)
+							   * static_cast<double>((m_height + stride - 1) / stride);
+		if (samples <= budgetSamples)
+			break;
+		stride *= 2;
 	}
+	return stride;
+}
 
-	const int groupSize = 16;
-	glDispatchCompute((ssWidth + groupSize - 1) / groupSize, (ssHeight + groupSize - 1) / groupSize, 1);
-	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+void FractalComputer::dispatchWithinBudget(const FractalState& state, const ReferenceOrbit* reference,
+										   const BlaTable* bla, const std::function<bool()>& isSuperseded)
+{
+	for (const GpuTimer::Measurement& measurement : m_gpuTimer.collect())
+	{
+		if (measurement.work <= 0.0)
+			continue;
+		const double nanosecondsPerSample = measurement.milliseconds * 1e6 / measurement.work;
+		m_nanosecondsPerSample = m_nanosecondsPerSample > 0.0
+									 ? std::lerp(m_nanosecondsPerSample, nanosecondsPerSample, SAMPLE_COST_SMOOTHING)
+									 : nanosecondsPerSample;
+		m_gpuFrameMilliseconds = measurement.milliseconds;
+	}
 
-	std::vector<unsigned char> buffer(ssWidth * ssHeight * 4);
-	ssTexture.bind();
-	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, buffer.data());
+	const double nanosecondsPerSample
+		= m_nanosecondsPerSample > 0.0 ? m_nanosecondsPerSample : INITIAL_NANOSECONDS_PER_SAMPLE;
+	double budgetSamples = FRAME_GPU_BUDGET_MS * 1e6 / nanosecondsPerSample;
+	double dispatchedSamples = 0.0;
+	const bool timed = m_gpuTimer.begin();
 
-	const int rowPitch = ssWidth * 4;
-	for (int y = 0; y < ssHeight / 2; ++y)
+	while (m_refineStride > 0)
 	{
-		std::span<uint8_t> bufferSpan(buffer.data(), buffer.size());
+		// Whatever was dispatched stays; the rest of the render is dropped for the newer view.
+		if (dispatchedSamples > 0.0 && isSuperseded && isSuperseded())
+			break;
 
-		const size_t offset1 = static_cast<size_t>(y) * static_cast<size_t>(rowPitch);
-		const size_t offset2 = static_cast<size_t>(ssHeight - 1 - y) * static_cast<size_t>(rowPitch);
+		const int tileSize = TILE_SAMPLES * m_refineStride;
+		const int columns = (m_width + tileSize - 1) / tileSize;
+		const int tileCount = columns * ((m_height + tileSize - 1) / tileSize);
+		const double tileSamples
+			= static_cast<double>(TILE_SAMPLES) * TILE_SAMPLES * (m_refinesCoarserPass ? REFINED_SAMPLE_SHARE : 1.0);
 
-		auto row1 = bufferSpan.subspan(offset1, rowPitch);
-		auto row2 = bufferSpan.subspan(offset2, rowPitch);
+		const double remainingTiles = tileCount - m_nextTile;
+		int count = static_cast<int>(std::min(budgetSamples / tileSamples, remainingTiles));
+		if (count <= 0)
+		{
+			if (dispatchedSamples > 0.0)
+				break;
+			count = 1;
+		}
+		// A render that can be superseded goes out a row of tiles at a time, checking in between.
+		if (isSuperseded)
+			count = std::min(count, columns - (m_nextTile % columns));
+		dispatchedSamples += dispatchTiles(state, reference, bla, m_nextTile, count);
+		budgetSamples -= count * tileSamples;
 
-		std::swap_ranges(row1.begin(), row1.end(), row2.begin());
+		m_nextTile += count;
+		if (m_nextTile == tileCount)
+		{
+			m_refineStride /= 2;
+			m_nextTile = 0;
+			m_refinesCoarserPass = true;
+		}
 	}
 
-	SDL_Surface* surface = SDL_CreateSurfaceFrom(ssWidth, ssHeight, SDL_PIXELFORMAT_ABGR8888, buffer.data(), rowPitch);
-	if (!surface)
+	if (timed)
+		m_gpuTimer.end(dispatchedSamples);
+	if (state.persistentThreads)
+		m_tileQueue.updateCosts();
+}
+
+double FractalComputer::dispatchTiles(const FractalState& state, const ReferenceOrbit* reference,
+									  const BlaTable* bla, int first, int count)
+{
+	const int tileSize = TILE_SAMPLES * m_refineStride;
+	const int columns = (m_width + tileSize - 1) / tileSize;
+	const double sampleShare = m_refinesCoarserPass ? REFINED_SAMPLE_SHARE : 1.0;
+
+	// A run of tiles in row order is a partial row, then whole rows, then another partial row.
+	double samples = 0.0;
+	const int end = first + count;
+	for (int tile = first; tile < end;)
 	{
-		FRACTAL_ERROR("Failed to create SDL_Surface for screenshot: {}", SDL_GetError());
+		const int row = tile / columns;
+		const int column = tile % columns;
+		const int rows = (column == 0 && end - tile >= columns) ? (end - tile) / columns : 1;
+		const int runColumns = rows > 1 ? columns : std::min(columns - column, end - tile);
+
+		const DispatchPass pass = { .x = column * tileSize,
+									.y = row * tileSize,
+									.width = std::min(runColumns * tileSize, m_width - (column * tileSize)),
+									.height = std::min(rows * tileSize, m_height - (row * tileSize)),
+									.sampleStride = m_refineStride,
+									.refinesCoarserPass = m_refinesCoarserPass,
+									.usesTileCosts = true };
+		dispatch(state, m_precision, reference, bla, *m_iterationTexture, m_width, m_height, pass);
+
+		samples += static_cast<double>((pass.width + m_refineStride - 1) / m_refineStride)
+				   * static_cast<double>((pass.height + m_refineStride - 1) / m_refineStride) * sampleShare;
+		tile += rows * runColumns;
+	}
+	return samples;
+}
+
+std::optional<glm::ivec2> FractalComputer::findPanShift(const FractalState& state) const
+{
+	if (!m_displayedView || m_displayedPrecision != m_precision)
+		return std::nullopt;
+
+	// Coloring is reapplied to the whole frame after the shift, so only the iterations have to match.
+	FractalState unpanned = state;
+	unpanned.offset = m_displayedView->offset;
+	unpanned.needsUpdate = m_displayedView->needsUpdate;
+	unpanned.coloring.palette = m_displayedView->coloring.palette;
+	unpanned.coloring.paletteFrequency = m_displayedView->coloring.paletteFrequency;
+	if (unpanned != *m_displayedView)
+		return std::nullopt;
+
+	// Image rows run top to bottom while the imaginary axis points up.
+	const double pixelsPerUnit = state.zoom * static_cast<double>(m_height);
+	const double shiftX = -(state.offset.x - m_displayedView->offset.x).toDouble() * pixelsPerUnit;
+	const double shiftY = (state.offset.y - m_displayedView->offset.y).toDouble() * pixelsPerUnit;
+	const double wholeX = std::round(shiftX);
+	const double wholeY = std::round(shiftY);
+	if (std::abs(shiftX - wholeX) > PAN_SNAP_TOLERANCE || std::abs(shiftY - wholeY) > PAN_SNAP_TOLERANCE)
+		return std::nullopt;
+	if (std::abs(wholeX) >= m_width || std::abs(wholeY) >= m_height)
+		return std::nullopt;
+
+	return glm::ivec2{ static_cast<int>(wholeX), static_cast<int>(wholeY) };
+}
+
+void FractalComputer::reprojectPan(const FractalState& state, const ReferenceOrbit* reference, const BlaTable* bla,
+								   glm::ivec2 shift)
+{
+	if (shift.x == 0 && shift.y == 0)
 		return;
+
+	const int keptWidth = m_width - std::abs(shift.x);
+	const int keptHeight = m_height - std::abs(shift.y);
+	glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+	glCopyImageSubData(m_iterationTexture->getID(), GL_TEXTURE_2D, 0, std::max(0, -shift.x), std::max(0, -shift.y),
+					   0, m_panIterationTexture->getID(), GL_TEXTURE_2D, 0, std::max(0, shift.x),
+					   std::max(0, shift.y), 0, keptWidth, keptHeight, 1);
+	std::swap(m_iterationTexture, m_panIterationTexture);
+
+	// The exposed L: whole columns on one side, then rows across the columns that were kept.
+	if (shift.x != 0)
+	{
+		dispatch(state, m_precision, reference, bla, *m_iterationTexture, m_width, m_height,
+				 { .x = shift.x > 0 ? 0 : keptWidth,
+				   .y = 0,
+				   .width = std::abs(shift.x),
+				   .height = m_height,
+				   .usesTileCosts = true });
+	}
+	if (shift.y != 0)
+	{
+		dispatch(state, m_precision, reference, bla, *m_iterationTexture, m_width, m_height,
+				 { .x = std::max(0, shift.x),
+				   .y = shift.y > 0 ? 0 : keptHeight,
+				   .width = keptWidth,
+				   .height = std::abs(shift.y),
+				   .usesTileCosts = true });
 	}
+}
 
-	bool success = false;
-	std::string pathStr = request.filepath.string();
+void FractalComputer::dispatch(const FractalState& state, KernelPrecision precision, const ReferenceOrbit* reference,
+							   const BlaTable* bla, Texture& target, int width, int height, const DispatchPass& pass)
+{
+	dispatchVariant(selectVariant(state.type, precision), state, reference, bla, target, width, height, pass);
+}
+
+void FractalComputer::dispatchVariant(const ShaderVariant& variant, const FractalState& state,
+									  const ReferenceOrbit* reference, const BlaTable* bla, Texture& target, int width,
+									  int height, const DispatchPass& pass)
+{
+	Shader& shader = getOrCreateShader(variant);
+	shader.use();
+
+	target.bindImage(0);
+	setViewUniforms(shader, state, width, height);
+	const bool wholeTarget = pass.width <= 0 || pass.height <= 0;
+	const glm::ivec2 regionOrigin = wholeTarget ? glm::ivec2{ 0, 0 } : glm::ivec2{ pass.x, pass.y };
+	const glm::ivec2 regionSize = wholeTarget ? glm::ivec2{ width, height } : glm::ivec2{ pass.width, pass.height };
+	shader.setVec2("regionOrigin", regionOrigin);
+	shader.setVec2("regionEnd", glm::ivec2{ regionOrigin.x + regionSize.x, regionOrigin.y + regionSize.y });
+	shader.setInt("sampleStride", pass.sampleStride);
+	shader.setBool("refinesCoarserPass", pass.refinesCoarserPass);
 
-	switch (request.format)
+	if (reference != nullptr)
 	{
-		case ScreenshotFormat::PNG:
-			success = IMG_SavePNG(surface, pathStr.c_str());
-			break;
-		case ScreenshotFormat::JPG:
+		if (!m_referenceUploaded)
 		{
-			SDL_Surface* rgbSurface = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGB24);
-			if (rgbSurface)
-			{
-				success = IMG_SaveJPG(rgbSurface, pathStr.c_str(), 95);
-				SDL_DestroySurface(rgbSurface);
-			}
-			else
-			{
-				FRACTAL_ERROR("Failed to convert surface for JPG saving: {}", SDL_GetError());
-			}
+			const auto& points = reference->getPoints();
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_referenceSSBO);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(points.size() * sizeof(glm::dvec2)),
+						 points.data(), GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, REFERENCE_ORBIT_BINDING, m_referenceSSBO);
+			m_referenceUploaded = true;
 		}
-		break;
-		case ScreenshotFormat::BMP:
-			success = SDL_SaveBMP(surface, pathStr.c_str());
-			break;
+		shader.setInt("referenceLength", reference->getLength());
+
+		if (bla != nullptr && !m_blaUploaded)
+		{
+			const auto& steps = bla->getSteps();
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_blaSSBO);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(steps.size() * sizeof(BlaStep)),
+						 steps.data(), GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BLA_TABLE_BINDING, m_blaSSBO);
+			m_blaUploaded = true;
+		}
+		shader.setBool("useBla", bla != nullptr);
+		shader.setInt("blaLevelCount", bla != nullptr ? bla->getLevelCount() : 0);
 	}
 
-	if (!success)
+	// One workgroup covers a tile of its group size times the samples each invocation takes.
+	const glm::ivec2 tileSamples = { variant.shape.groupWidth * variant.shape.samplesX,
+									 variant.shape.groupHeight * variant.shape.samplesY };
+	shader.setBool("persistentThreads", state.persistentThreads);
+	if (state.persistentThreads)
 	{
-		FRACTAL_ERROR("Failed to save screenshot: {}", SDL_GetError());
+		const int tileCount
+			= m_tileQueue.prepare(shader, width, height, regionOrigin, regionSize, pass.sampleStride, tileSamples,
+								  pass.usesTileCosts);
+		glDispatchCompute(static_cast<GLuint>(std::min(tileCount, PERSISTENT_WORKGROUPS)), 1, 1);
 	}
 	else
 	{
-		FRACTAL_INFO("Screenshot saved to {}", request.filepath.string());
+		const int samplesX = (regionSize.x + pass.sampleStride - 1) / pass.sampleStride;
+		const int samplesY = (regionSize.y + pass.sampleStride - 1) / pass.sampleStride;
+		glDispatchCompute((samplesX + tileSamples.x - 1) / tileSamples.x,
+						  (samplesY + tileSamples.y - 1) / tileSamples.y, 1);
+	}
+	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+}
+
+void FractalComputer::validateIterationSkipping(const FractalState& state)
+{
+	const KernelPrecision precision = selectPrecision(state, m_height, m_precision);
+	const ReferenceOrbit* reference = prepareReferenceOrbit(state, precision, m_height);
+	const BlaTable* bla = prepareBlaTable(state, reference, m_width, m_height);
+	if (bla == nullptr)
+	{
+		FRACTAL_WARN("Iteration skipping does not apply to this view; nothing to validate.");
+		m_skippingReport = IterationSkippingReport{};
+		return;
+	}
+
+	const int width = std::max(1, m_width / VALIDATION_DOWNSCALE);
+	const int height = std::max(1, m_height / VALIDATION_DOWNSCALE);
+	m_skippingReport = m_cpuRenderer->compareIterationSkipping(state, width, height, *reference, *bla);
+	m_stats.skippingReport = m_skippingReport;
+
+	FRACTAL_INFO("Iteration skipping check at {}x{}: {:.2f}% of pixels differ (max {:.3f} iterations), {:.1f}% of "
+				 "iterations skipped.",
+				 width, height, m_skippingReport.mismatchedPixelRatio * 100.0, m_skippingReport.maxDifference,
+				 m_skippingReport.skippedIterationRatio * 100.0);
+}
+
+void FractalComputer::compareTileScheduling(const FractalState& state)
+{
+	const KernelPrecision precision = selectPrecision(state, m_height, m_precision);
+	const ReferenceOrbit* reference = prepareReferenceOrbit(state, precision, m_height);
+	const BlaTable* bla = state.useIterationSkipping ? prepareBlaTable(state, reference, m_width, m_height) : nullptr;
+
+	FractalState fixedGrid = state;
+	fixedGrid.persistentThreads = false;
+	FractalState persistent = state;
+	persistent.persistentThreads = true;
+
+	// Both persistent passes cover the view at full resolution, so they read and write its stride-1 cost grid.
+	Texture iterations(m_width, m_height, GL_R32F);
+	auto timePass = [&](const FractalState& variant) {
+		GpuTimer timer;
+		timer.begin();
+		dispatch(variant, precision, reference, bla, iterations, m_width, m_height,
+				 { .usesTileCosts = variant.persistentThreads });
+		timer.end(0.0);
+		const std::vector<GpuTimer::Measurement> measurements = timer.collect(true);
+		return measurements.empty() ? 0.0 : measurements.front().milliseconds;
+	};
+
+	// The untimed run records the tile costs the timed one is ordered by.
+	timePass(persistent);
+	m_tileQueue.updateCosts(true);
+
+	m_schedulingReport = { .valid = true,
+						   .width = m_width,
+						   .height = m_height,
+						   .fixedGridMilliseconds = timePass(fixedGrid),
+						   .persistentMilliseconds = timePass(persistent) };
+	m_stats.schedulingReport = m_schedulingReport;
+
+	FRACTAL_INFO("Tile scheduling at {}x{}: fixed grid {:.2f} ms, persistent threads {:.2f} ms ({:.2f}x).", m_width,
+				 m_height, m_schedulingReport.fixedGridMilliseconds, m_schedulingReport.persistentMilliseconds,
+				 m_schedulingReport.fixedGridMilliseconds / std::max(m_schedulingReport.persistentMilliseconds, 1e-9));
+}
+
+void FractalComputer::saveScreenshot(const ScreenshotRequest& request, const FractalState& state)
+{
+	FRACTAL_INFO("Taking screenshot... Scale: {}x, Supersample: {}x, Path: {}", request.scale, request.supersample,
+				 request.filepath.string());
+
+	const int width = state.renderWidth * request.scale;
+	const int height = state.renderHeight * request.scale;
+
+	if (width <= 0 || height <= 0)
+	{
+		FRACTAL_ERROR("Cannot save screenshot with invalid dimensions ({}x{}).", width, height);
+		return;
+	}
+
+	if (state.backend == RenderBackend::CPU)
+	{
+		ImageExport::saveAsync(*m_scheduler, request, width, height,
+							   renderImage(state, width, height, request.supersample, request.filter),
+							   ImageExport::RowOrder::BottomUp);
+		return;
+	}
+
+	const int sampleEdge
+		= (std::max(width, height) + (2 * Supersampling::getMargin(request.filter))) * request.supersample;
+	if (sampleEdge > m_maxTextureSize)
+	{
+		FRACTAL_ERROR("A {}x{} screenshot at {}x supersampling needs textures {} pixels wide, more than the GPU's "
+					  "limit of {}. Use a tiled export instead.",
+					  width, height, request.supersample, sampleEdge, m_maxTextureSize);
+		return;
 	}
 
-	SDL_DestroySurface(surface);
+	// The texture can go once the copy is queued: GL only deletes it after the commands using it have run.
+	Texture image(width, height);
+	renderSupersampled(state, request.supersample, request.filter, image);
+
+	PendingScreenshot& screenshot = m_pendingScreenshots.emplace_back();
+	screenshot.request = request;
+	screenshot.width = width;
+	screenshot.height = height;
+	screenshot.readback.start(image);
+}
+
+void FractalComputer::pollScreenshots()
+{
+	std::erase_if(m_pendingScreenshots, [this](PendingScreenshot& screenshot) {
+		if (!screenshot.readback.isReady())
+			return false;
+		encodeScreenshot(screenshot);
+		return true;
+	});
+}
+
+void FractalComputer::encodeScreenshot(PendingScreenshot& screenshot)
+{
+	std::vector<uint8_t> pixels = screenshot.readback.finish();
+	if (pixels.empty())
+		return;
+
+	ImageExport::saveAsync(*m_scheduler, screenshot.request, screenshot.width, screenshot.height, std::move(pixels),
+						   ImageExport::RowOrder::TopDown);
+}
+
+std::vector<uint8_t> FractalComputer::renderImage(const FractalState& state, int width, int height, int supersample,
+												 ResolveFilter filter)
+{
+	std::vector<uint8_t> buffer;
+	if (state.backend == RenderBackend::GPU)
+	{
+		Texture image(width, height);
+		renderSupersampled(state, supersample, filter, image);
+
+		buffer.resize(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+		image.bind();
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, buffer.data());
+		return buffer;
+	}
+
+	FractalState view = state;
+	view.renderWidth = width;
+	view.renderHeight = height;
+	if (supersample > 1)
+		view = Supersampling::getSampleView(view, supersample, filter);
+
+	const KernelPrecision precision = selectPrecision(view, view.renderHeight, m_precision);
+	const ReferenceOrbit* reference = prepareReferenceOrbit(view, precision, view.renderHeight);
+	const BlaTable* bla = view.useIterationSkipping
+							  ? prepareBlaTable(view, reference, view.renderWidth, view.renderHeight)
+							  : nullptr;
+
+	m_cpuRenderer->render(view, view.renderWidth, view.renderHeight, buffer, reference, bla);
+	m_renderedView.reset(); // The renderer's iteration buffer now holds this image.
+	if (supersample > 1)
+		buffer = Supersampling::resolve(*m_scheduler, buffer, width, height, supersample, filter);
+	return buffer;
+}
+
+void FractalComputer::renderSupersampled(const FractalState& state, int supersample, ResolveFilter filter,
+										 Texture& image)
+{
+	FractalState view = state;
+	view.renderWidth = image.getWidth();
+	view.renderHeight = image.getHeight();
+	if (supersample <= 1)
+	{
+		Texture iterations(view.renderWidth, view.renderHeight, GL_R32F);
+		renderToTexture(view, iterations, image);
+		return;
+	}
+
+	const FractalState samples = Supersampling::getSampleView(view, supersample, filter);
+	Texture iterations(samples.renderWidth, samples.renderHeight, GL_R32F);
+	Texture sampleImage(samples.renderWidth, samples.renderHeight);
+	renderToTexture(samples, iterations, sampleImage);
+	resolveSamples(sampleImage, supersample, filter, image);
+}
+
+void FractalComputer::renderToTexture(const FractalState& state, Texture& iterations, Texture& image)
+{
+	const int width = image.getWidth();
+	const int height = image.getHeight();
+	const KernelPrecision precision = selectPrecision(state, height, m_precision);
+	const ReferenceOrbit* reference = prepareReferenceOrbit(state, precision, height);
+	const BlaTable* bla = state.useIterationSkipping ? prepareBlaTable(state, reference, width, height) : nullptr;
+
+	dispatch(state, precision, reference, bla, iterations, width, height);
+	colorize(state.coloring, iterations, image);
 }
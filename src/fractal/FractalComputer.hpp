@@ -1,17 +1,125 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "FractalState.hpp"
+#include "BlaTable.hpp"
+#include "KernelTuner.hpp"
+#include "ReferenceOrbit.hpp"
+#include "TileQueue.hpp"
+#include "core/TaskScheduler.hpp"
+#include "gfx/GpuTimer.hpp"
+#include "gfx/PixelReadback.hpp"
 #include "gfx/Shader.hpp"
+#include "gfx/ShaderCache.hpp"
+#include "gfx/ShaderPreprocessor.hpp"
+#include "cpu/CpuFractalRenderer.hpp"
 #include "gfx/Texture.hpp"
 #include "ui/UIState.hpp"
 #include <glad/gl.h>
 
-// Maximum number of color stops we support in the palette.
-constexpr int MAX_PALETTE_STOPS = 16;
+// Most color stops the palette editor adds by clicking. Presets may hold any number, since the palette is baked into a
+// lookup table before rendering.
+constexpr int MAX_PALETTE_STOPS = 64;
+
+// Arithmetic a view is rendered with, from cheapest to deepest.
+enum class KernelPrecision
+{
+	Float, // GPU only; the CPU backend renders this tier in double.
+	Double,
+	DoubleDouble, // Emulated ~106-bit mantissa on the GPU, for fractals without a perturbation path.
+	Perturbation,
+};
+
+inline std::string_view getPrecisionName(KernelPrecision precision)
+{
+	switch (precision)
+	{
+		case KernelPrecision::Float:
+			return "fp32";
+		case KernelPrecision::DoubleDouble:
+			return "double-double";
+		case KernelPrecision::Perturbation:
+			return "perturbation";
+		case KernelPrecision::Double:
+			break;
+	}
+	return "fp64";
+}
+
+// Cheapest tier that resolves the view at this height. `current` is the tier used so far; dropping to a cheaper one
+// takes a margin, so views near a threshold do not flip kernels every frame.
+KernelPrecision selectPrecision(const FractalState& state, int height, KernelPrecision current);
+
+// GPU time of one full-resolution pass over the view with the fixed grid of workgroups and with persistent threads.
+struct TileSchedulingReport
+{
+		bool valid = false;
+		int width = 0;
+		int height = 0;
+		double fixedGridMilliseconds = 0.0;
+		double persistentMilliseconds = 0.0;
+};
+
+// Views the UI submitted since launch, as the render thread handled them.
+struct RenderJobCounts
+{
+		uint64_t started = 0;
+		uint64_t dropped = 0;	// Replaced by a newer view before they started.
+		uint64_t cancelled = 0; // Replaced by a newer view before their render finished.
+};
+
+struct RenderStats
+{
+		RenderBackend backend = RenderBackend::GPU;
+		std::string_view cpuIsa;
+		double milliseconds = 0.0;
+		double megapixelsPerSecond = 0.0;
+		double gpuFrameMilliseconds = 0.0; // Last measured GPU time of one frame's share of the view.
+		double filledPixelRatio = 0.0;
+		std::vector<WorkerStats> workers;
+
+		KernelPrecision precision = KernelPrecision::Double;
+		int referenceIterations = 0;
+		int referencePrecisionBits = 0;
+		bool iterationSkipping = false;
+
+		IterationSkippingReport skippingReport; // Last validation run, kept across frames.
+		TileSchedulingReport schedulingReport;	// Last comparison, kept across frames.
+		RenderJobCounts jobs;					// Filled in by the render thread.
+};
+
+// Which pixels of the target one dispatch computes: a sampleStride grid over the region (the whole target when
+// width or height is 0), skipping the samples a pass of twice the stride already took when refinesCoarserPass is
+// set.
+struct DispatchPass
+{
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+		int sampleStride = 1;
+		bool refinesCoarserPass = false;
+		bool usesTileCosts = false; // Orders the persistent-thread queue by the view's tile costs and records them.
+};
+
+// Identifies one compiled permutation of MainShader.glsl.
+struct ShaderVariant
+{
+		FractalType type = FractalType::Mandelbrot;
+		KernelPrecision precision = KernelPrecision::Double;
+		KernelShape shape;
+
+		auto operator<=>(const ShaderVariant&) const = default;
+};
 
 class FractalComputer
 {
@@ -19,21 +127,177 @@ class FractalComputer
 		FractalComputer(int width, int height);
 		~FractalComputer();
 
-		void generate(const FractalState& state);
+		// Renders the view. The GPU backend only dispatches as much of it as fits the frame's GPU time budget,
+		// starting with a coarse pass when progressive rendering is on. Once `isSuperseded` returns true, the GPU
+		// backend stops at the next row of tiles and leaves the render unfinished; generate() the newer view next.
+		void generate(const FractalState& state, const std::function<bool()>& isSuperseded = {});
+		// Continues a GPU render started by generate() with the next frame's budget.
+		void refine(const FractalState& state, const std::function<bool()>& isSuperseded = {});
+		[[nodiscard]] bool isRefining() const { return m_refineStride > 0; }
+		// Collects shader variants that finished compiling in the background and times the next kernel shape being
+		// tuned; meant for otherwise idle frames.
+		void pollShaderWarmUp();
 		void onResize(int newWidth, int newHeight);
+		// Starts rendering a screenshot and returns without waiting for the GPU; pollScreenshots() saves it once the
+		// pixels have been read back. The CPU backend renders right away and only encodes in the background.
 		void saveScreenshot(const ScreenshotRequest& request, const FractalState& state);
+		// Hands every screenshot whose readback has finished to an encoder; call once per frame.
+		void pollScreenshots();
+		// Renders the view at an arbitrary size with the state's backend and returns RGBA8 rows bottom to top. With
+		// supersampling the samples are filtered down to that size, on the GPU or the worker pool.
+		std::vector<uint8_t> renderImage(const FractalState& state, int width, int height, int supersample = 1,
+										 ResolveFilter filter = ResolveFilter::Box);
+		// Queues a GPU render of the view at the size of `image` without waiting for it; `iterations` (GL_R32F, same
+		// size) receives the iteration counts. Read the result back with a PixelReadback to keep the pipeline full.
+		void renderToTexture(const FractalState& state, Texture& iterations, Texture& image);
+		// Like renderToTexture, with supersample x supersample samples per pixel resolved into `image` on the GPU;
+		// the sample and iteration textures are temporary.
+		void renderSupersampled(const FractalState& state, int supersample, ResolveFilter filter, Texture& image);
+		// Renders a reduced-size sample of the view on the CPU with and without iteration skipping and compares.
+		void validateIterationSkipping(const FractalState& state);
+		// Times a full-resolution GPU pass over the view with the fixed grid and with persistent threads, the latter
+		// ordered by the tile costs an untimed persistent pass recorded just before, as the interactive view would be.
+		// Waits for the GPU.
+		void compareTileScheduling(const FractalState& state);
 
-		[[nodiscard]] GLuint getTextureID() const { return m_texture->getID(); }
+		// Colored frame of the interactive view.
+		[[nodiscard]] const Texture& getTexture() const { return *m_texture; }
+		[[nodiscard]] const RenderStats& getStats() const { return m_stats; }
+		// Worker pool of the CPU backend, also used to encode exported images off the UI thread.
+		[[nodiscard]] TaskScheduler& getScheduler() { return *m_scheduler; }
 
 	private:
-		Shader& getOrCreateShader(FractalType type);
-		void updatePaletteUBO(const ColoringParams& coloring);
+		struct PendingScreenshot
+		{
+				ScreenshotRequest request;
+				int width = 0;
+				int height = 0;
+				PixelReadback readback;
+		};
+
+		Shader& getOrCreateShader(const ShaderVariant& variant);
+		// Starts every variant up front: cached binaries load right away, the rest compile in the background.
+		void warmUpShaders();
+		// Runs the preprocessor and adds the time it took to m_preprocessTime.
+		PreprocessedShader preprocess(std::string_view path, const std::vector<std::string>& defines = {});
+		// Loads a shader without variants from the program cache, compiling and caching it on a miss.
+		void loadShader(std::string_view path, Shader& shader);
+		// Creates the variant from the program cache, or starts compiling it when there is no usable binary.
+		void startShader(const ShaderVariant& variant);
+		// Waits for a variant that is still compiling and caches its binary.
+		void finishShader(const ShaderVariant& variant);
+		// Variant to render `type` with: the tuned shape, or the default one while the tuned shape still compiles.
+		[[nodiscard]] ShaderVariant selectVariant(FractalType type, KernelPrecision precision) const;
+		// Starts compiling the candidate shapes of `type` unless it is tuned already or another type is being tuned.
+		void startKernelTuning(const FractalState& state);
+		// Records the tuning runs that finished and dispatches the next one once its candidate has compiled.
+		void advanceKernelTuning();
+		// Rebakes and uploads the palette lookup table when the stops changed since the last upload.
+		void updatePaletteTexture(const std::vector<ColorStop>& palette);
+		void setViewUniforms(const Shader& shader, const FractalState& state, int width, int height) const;
+		void generateOnCpu(const FractalState& state, const ReferenceOrbit* reference, const BlaTable* bla);
+		// Collects the pixels of a screenshot, waiting for its readback if needed, and queues the encode.
+		void encodeScreenshot(PendingScreenshot& screenshot);
+		// Maps an iteration buffer through the palette into `target`, which must be the same size.
+		void colorize(const ColoringParams& coloring, Texture& iterations, Texture& target);
+		// Filters an RGBA8 sample grid from Supersampling::getSampleView down into `target`.
+		void resolveSamples(const Texture& samples, int factor, ResolveFilter filter, Texture& target);
+		// True when `state` differs from the last rendered view only in palette or palette frequency.
+		[[nodiscard]] bool onlyColoringChanged(const FractalState& state) const;
+		// Recolors the last rendered view with the coloring of `state`; false if its iterations are gone.
+		bool recolor(const FractalState& state);
+		// Dispatches the view's fractal at `precision` in the shape selectVariant() picks.
+		void dispatch(const FractalState& state, KernelPrecision precision, const ReferenceOrbit* reference,
+					  const BlaTable* bla, Texture& target, int width, int height, const DispatchPass& pass = {});
+		void dispatchVariant(const ShaderVariant& variant, const FractalState& state, const ReferenceOrbit* reference,
+							 const BlaTable* bla, Texture& target, int width, int height,
+							 const DispatchPass& pass = {});
+		// Stride of the first pass into m_iterationTexture: the finest one whose samples fit the frame budget.
+		[[nodiscard]] int chooseFirstStride(bool progressive) const;
+		// Dispatches the next tiles of the render into m_iterationTexture, moving on to finer passes as they
+		// complete, until the frame budget is used up or the render is superseded. At least one tile goes out every
+		// frame.
+		void dispatchWithinBudget(const FractalState& state, const ReferenceOrbit* reference, const BlaTable* bla,
+								  const std::function<bool()>& isSuperseded);
+		// Dispatches `count` tiles of the current pass in row order, as at most three rectangles, and returns the
+		// number of samples they compute.
+		double dispatchTiles(const FractalState& state, const ReferenceOrbit* reference, const BlaTable* bla,
+							 int first, int count);
+
+		// Shift in pixels when `state` only pans the complete frame in m_iterationTexture by whole pixels.
+		[[nodiscard]] std::optional<glm::ivec2> findPanShift(const FractalState& state) const;
+		// Moves the previous frame by `shift` and renders just the strips the pan exposed.
+		void reprojectPan(const FractalState& state, const ReferenceOrbit* reference, const BlaTable* bla,
+						  glm::ivec2 shift);
+
+		// Returns the reference orbit to render against, or nullptr when the view does not need perturbation.
+		const ReferenceOrbit* prepareReferenceOrbit(const FractalState& state, KernelPrecision precision, int height);
+		// Returns the approximation table for the current orbit, or nullptr when it is disabled or would not help.
+		const BlaTable* prepareBlaTable(const FractalState& state, const ReferenceOrbit* reference, int width,
+										int height);
 
 		int m_width;
 		int m_height;
-		std::unique_ptr<Texture> m_texture;
+		std::unique_ptr<Texture> m_texture; // Colored frame shown by the UI.
+		// Smoothed iteration count of every pixel on the GPU backend, kept so palette edits only rerun the color pass.
+		std::unique_ptr<Texture> m_iterationTexture;
+		std::unique_ptr<Texture> m_panIterationTexture; // Destination of the next pan shift, swapped in afterwards.
+
+		std::map<ShaderVariant, std::unique_ptr<Shader>> m_shaderCache;
+		// Preprocessed source of every variant still compiling, which keys its binary once it links.
+		std::map<ShaderVariant, std::string> m_compilingSources;
+		ShaderPreprocessor m_preprocessor;
+		std::unique_ptr<ShaderCache> m_programCache;
+		bool m_parallelCompile = false;
+		std::chrono::steady_clock::time_point m_warmUpStart;
+		size_t m_warmUpCompiles = 0; // Variants the startup warm-up had to compile; 0 once they are all done.
+		std::chrono::steady_clock::duration m_preprocessTime{}; // Spent in m_preprocessor, logged at trace level.
+		// Kernel shape of every fractal type, and the view and target the one being tuned is timed on.
+		std::unique_ptr<KernelTuner> m_kernelTuner;
+		std::optional<FractalState> m_tuningView;
+		std::unique_ptr<Texture> m_tuningTexture;
+		GpuTimer m_tuningTimer;
+		Shader m_colorShader;
+		Shader m_resolveShader;
+		// Tier of the interactive view, kept between frames for hysteresis.
+		KernelPrecision m_precision = KernelPrecision::Float;
+		// Render into m_iterationTexture in progress: stride of the current pass (0 once the view is complete), its
+		// next tile, and whether it skips the samples of the pass before.
+		int m_refineStride = 0;
+		int m_nextTile = 0;
+		bool m_refinesCoarserPass = false;
+		// Times each frame's dispatches; the running cost per sample sizes the next frame's share.
+		GpuTimer m_gpuTimer;
+		double m_nanosecondsPerSample = 0.0; // 0 until the first measurement arrives.
+		double m_gpuFrameMilliseconds = 0.0;
+		// View whose iterations are held for recoloring (m_iterationTexture, or the CPU renderer's buffer).
+		std::optional<FractalState> m_renderedView;
+		// View and tier of the complete GPU frame in m_iterationTexture, if there is one.
+		std::optional<FractalState> m_displayedView;
+		KernelPrecision m_displayedPrecision = KernelPrecision::Float;
+
+		GLuint m_paletteTexture = 0;
+		std::vector<ColorStop> m_bakedPalette; // Stops currently in m_paletteTexture.
+		bool m_paletteUploaded = false;
+
+		ReferenceOrbit m_referenceOrbit;
+		GLuint m_referenceSSBO = 0;
+		bool m_referenceUploaded = false;
+
+		BlaTable m_blaTable;
+		GLuint m_blaSSBO = 0;
+		double m_blaPixelDelta = 0.0;
+		bool m_blaStale = true;
+		bool m_blaUploaded = false;
+		IterationSkippingReport m_skippingReport;
+		TileQueue m_tileQueue;
+		TileSchedulingReport m_schedulingReport;
 
-		std::map<FractalType, std::unique_ptr<Shader>> m_shaderCache;
+		std::vector<PendingScreenshot> m_pendingScreenshots; // Rendered on the GPU, oldest first.
+		GLint m_maxTextureSize = 0;
 
-		GLuint m_paletteUBO = 0;
+		std::unique_ptr<TaskScheduler> m_scheduler;
+		std::unique_ptr<CpuFractalRenderer> m_cpuRenderer;
+		std::vector<uint8_t> m_cpuPixels;
+		RenderStats m_stats;
 };
@@ -12,6 +12,11 @@ struct FractalDefinition
 		std::string_view shaderDefine;
 };
 
+// Added next to a fractal's shaderDefine to select the precision tier of its kernel.
+constexpr std::string_view SINGLE_PRECISION_SHADER_DEFINE = "FRACTAL_SINGLE_PRECISION";
+constexpr std::string_view DOUBLE_DOUBLE_SHADER_DEFINE = "FRACTAL_DOUBLE_DOUBLE";
+constexpr std::string_view PERTURBATION_SHADER_DEFINE = "FRACTAL_PERTURBATION";
+
 static const std::map<FractalType, FractalDefinition> FractalDefinitions
 	= { { FractalType::Mandelbrot, { "Mandelbrot", "FRACTAL_MANDELBROT" } },
 		{ FractalType::Julia, { "Julia", "FRACTAL_JULIA" } },
@@ -6,10 +6,12 @@
 
 struct FractalState
 {
+		static constexpr int DEFAULT_COORDINATE_LIMBS = 2;
+
 		int renderWidth = 1280;
 		int renderHeight = 720;
 		FractalType type = FractalType::Mandelbrot;
-		glm::dvec2 offset = { -0.75, 0.0 };
+		BigVec2 offset = { BigFixed(-0.75, DEFAULT_COORDINATE_LIMBS), BigFixed(0.0, DEFAULT_COORDINATE_LIMBS) };
 		double zoom = 0.4;
 		int maxIterations = 256;
 
@@ -17,5 +19,19 @@ struct FractalState
 
 		ColoringParams coloring;
 
+		RenderBackend backend = RenderBackend::GPU;
+		// GPU only: show a coarse pass right away and refine it to full resolution over the following frames.
+		bool progressiveRendering = true;
+		// GPU only: a fixed set of workgroups takes tiles off a queue, most expensive first, instead of launching one
+		// workgroup per tile.
+		bool persistentThreads = false;
+		// Deep Mandelbrot zooms skip iterations with bilinear approximations; off iterates every step.
+		bool useIterationSkipping = true;
+		// Mandelbrot and Julia on the CPU backend: fill rectangles whose computed border has a single value instead
+		// of iterating their inside.
+		bool useRectangleSubdivision = false;
+
 		bool needsUpdate = true;
+
+		bool operator==(const FractalState& other) const = default;
 };
@@ -6,6 +6,8 @@
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
+#include "util/BigFixed.hpp"
+
 enum class FractalType
 {
 	Mandelbrot,
@@ -16,9 +18,32 @@ enum class FractalType
 	Newton
 };
 
+enum class RenderBackend
+{
+	GPU,
+	CPU
+};
+
+// Point in the complex plane at arbitrary precision, used for the view center.
+struct BigVec2
+{
+		BigFixed x;
+		BigFixed y;
+
+		[[nodiscard]] glm::dvec2 toDouble() const { return { x.toDouble(), y.toDouble() }; }
+		[[nodiscard]] BigVec2 withPrecision(int fractionLimbs) const
+		{
+			return { x.withPrecision(fractionLimbs), y.withPrecision(fractionLimbs) };
+		}
+
+		bool operator==(const BigVec2& other) const = default;
+};
+
 struct FractalSpecificParams
 {
 		glm::dvec2 juliaConstant = { -0.8, 0.156 };
+
+		bool operator==(const FractalSpecificParams& other) const = default;
 };
 
 struct ColorStop
@@ -48,4 +73,6 @@ struct ColoringParams
 
 			{ { 1.0f, 1.0f, 1.0f }, 1.0f }
 		};
+
+		bool operator==(const ColoringParams& other) const = default;
 };
@@ -0,0 +1,131 @@
+#include "KernelTuner.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <system_error>
+#include <utility>
+
+#include <glad/gl.h>
+
+#include "FractalDefinition.hpp"
+#include "util/JsonUtils.hpp"
+#include "util/Logger.hpp"
+
+namespace
+{
+	constexpr int TOTAL_RUNS = static_cast<int>(KernelTuner::CANDIDATES.size()) * KernelTuner::RUNS_PER_CANDIDATE;
+
+	std::string glString(GLenum name)
+	{
+		const auto* value = reinterpret_cast<const char*>(glGetString(name));
+		return value != nullptr ? value : "";
+	}
+}
+
+KernelTuner::KernelTuner(std::filesystem::path path) : m_path(std::move(path))
+{
+	m_device = std::format("{}\n{}\n{}", glString(GL_VENDOR), glString(GL_RENDERER), glString(GL_VERSION));
+
+	std::ifstream file(m_path);
+	if (!file.is_open())
+		return;
+
+	try
+	{
+		json j;
+		file >> j;
+		if (j.at("device").get<std::string>() != m_device)
+		{
+			FRACTAL_INFO("Kernel shapes in {} were tuned on another device; tuning again.", m_path.string());
+			return;
+		}
+
+		const json& shapes = j.at("shapes");
+		for (const auto& [type, definition] : FractalDefinitions)
+		{
+			const std::string name(definition.name);
+			if (!shapes.contains(name))
+				continue;
+
+			const auto values = shapes.at(name).get<std::array<int, 4>>();
+			const KernelShape shape
+				= { .groupWidth = values[0], .groupHeight = values[1], .samplesX = values[2], .samplesY = values[3] };
+			if (std::ranges::find(CANDIDATES, shape) != CANDIDATES.end())
+				m_shapes[type] = shape;
+		}
+	}
+	catch (const json::exception& e)
+	{
+		FRACTAL_WARN("Ignoring kernel shapes in {}: {}", m_path.string(), e.what());
+		m_shapes.clear();
+	}
+}
+
+KernelShape KernelTuner::getShape(FractalType type) const
+{
+	const auto it = m_shapes.find(type);
+	return it != m_shapes.end() ? it->second : CANDIDATES.front();
+}
+
+bool KernelTuner::start(FractalType type)
+{
+	if (m_tuningType || isTuned(type))
+		return false;
+
+	m_tuningType = type;
+	m_bestMilliseconds.fill(std::numeric_limits<double>::infinity());
+	m_startedRuns = 0;
+	m_finishedRuns = 0;
+	return true;
+}
+
+std::optional<int> KernelTuner::getNextRun() const
+{
+	if (!m_tuningType || m_startedRuns >= TOTAL_RUNS)
+		return std::nullopt;
+	return m_startedRuns % static_cast<int>(CANDIDATES.size());
+}
+
+std::optional<KernelShape> KernelTuner::record(int candidate, double milliseconds)
+{
+	if (!m_tuningType || candidate < 0 || candidate >= static_cast<int>(CANDIDATES.size()))
+		return std::nullopt;
+
+	double& best = m_bestMilliseconds[static_cast<size_t>(candidate)];
+	if (milliseconds > 0.0)
+		best = std::min(best, milliseconds);
+	if (++m_finishedRuns < TOTAL_RUNS)
+		return std::nullopt;
+
+	const auto fastest = std::ranges::min_element(m_bestMilliseconds) - m_bestMilliseconds.begin();
+	const KernelShape shape = CANDIDATES[static_cast<size_t>(fastest)];
+	FRACTAL_INFO("Tuned {} kernels: {}x{} workgroups, {}x{} samples per invocation, {:.2f} ms against {:.2f} ms with "
+				 "the default shape.",
+				 FractalDefinitions.at(*m_tuningType).name, shape.groupWidth, shape.groupHeight, shape.samplesX,
+				 shape.samplesY, m_bestMilliseconds[static_cast<size_t>(fastest)], m_bestMilliseconds.front());
+
+	m_shapes[*m_tuningType] = shape;
+	m_tuningType.reset();
+	save();
+	return shape;
+}
+
+void KernelTuner::save() const
+{
+	json shapes = json::object();
+	for (const auto& [type, shape] : m_shapes)
+	{
+		shapes[std::string(FractalDefinitions.at(type).name)]
+			= { shape.groupWidth, shape.groupHeight, shape.samplesX, shape.samplesY };
+	}
+	const json j = { { "device", m_device }, { "shapes", shapes } };
+
+	std::error_code error;
+	std::filesystem::create_directories(m_path.parent_path(), error);
+	std::ofstream file(m_path, std::ios::trunc);
+	file << j.dump(4);
+	if (!file)
+		FRACTAL_WARN("Failed to write kernel shapes to {}", m_path.string());
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+
+#include "FractalTypes.hpp"
+
+// Workgroup size of MainShader.glsl and the samples each invocation takes, compiled into every variant.
+struct KernelShape
+{
+		int groupWidth = 16;
+		int groupHeight = 16;
+		int samplesX = 1;
+		int samplesY = 1;
+
+		auto operator<=>(const KernelShape&) const = default;
+};
+
+// Picks the KernelShape of every fractal by timing a few candidates on this GPU the first time the fractal is
+// rendered, and keeps the winners in a file next to the shader cache. The file is tied to the GL vendor, renderer and
+// version it was tuned with; any other device tunes again. The tuner only keeps the books: FractalComputer compiles
+// the candidates and times them in idle frames.
+class KernelTuner
+{
+	public:
+		// The first candidate is the shape a fractal renders with until it is tuned.
+		static constexpr std::array<KernelShape, 6> CANDIDATES = { {
+			{ .groupWidth = 16, .groupHeight = 16, .samplesX = 1, .samplesY = 1 },
+			{ .groupWidth = 32, .groupHeight = 8, .samplesX = 1, .samplesY = 1 },
+			{ .groupWidth = 8, .groupHeight = 8, .samplesX = 1, .samplesY = 1 },
+			{ .groupWidth = 16, .groupHeight = 16, .samplesX = 2, .samplesY = 2 },
+			{ .groupWidth = 16, .groupHeight = 16, .samplesX = 4, .samplesY = 1 },
+			{ .groupWidth = 8, .groupHeight = 8, .samplesX = 2, .samplesY = 2 },
+		} };
+		// Every candidate is timed this often, in turns, and its fastest run counts.
+		static constexpr int RUNS_PER_CANDIDATE = 3;
+
+		// Reads the winners stored for the current device; needs the GL context current.
+		explicit KernelTuner(std::filesystem::path path);
+
+		[[nodiscard]] KernelShape getShape(FractalType type) const;
+		[[nodiscard]] bool isTuned(FractalType type) const { return m_shapes.contains(type); }
+		[[nodiscard]] std::optional<FractalType> getTuningType() const { return m_tuningType; }
+
+		// Starts tuning `type`; false when it is tuned already or another fractal is being tuned.
+		bool start(FractalType type);
+		// Candidate of the next run to time, or nullopt once every run has been started.
+		[[nodiscard]] std::optional<int> getNextRun() const;
+		void markRunStarted() { ++m_startedRuns; }
+		// Records a timed run. The last one decides the winner, which is stored, written to disk and returned.
+		std::optional<KernelShape> record(int candidate, double milliseconds);
+
+	private:
+		void save() const;
+
+		std::filesystem::path m_path;
+		std::string m_device;
+		std::map<FractalType, KernelShape> m_shapes;
+
+		std::optional<FractalType> m_tuningType;
+		std::array<double, CANDIDATES.size()> m_bestMilliseconds{};
+		int m_startedRuns = 0;
+		int m_finishedRuns = 0;
+};
@@ -0,0 +1,154 @@
+#include "Keyframes.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include <glm/glm.hpp>
+
+namespace
+{
+	// Zoom ratios closer to 1 than this are a plain pan, which moves the center linearly.
+	constexpr double SAME_ZOOM_TOLERANCE = 1e-12;
+	// Significant bits the pan weight keeps when it is turned into a fixed-point factor.
+	constexpr int WEIGHT_BITS = 53;
+
+	// Gradient color at `position` of a palette sorted by position, as PaletteLut::bake would compute it.
+	glm::vec3 evaluatePalette(const std::vector<ColorStop>& sorted, float position)
+	{
+		if (position <= sorted.front().position)
+			return sorted.front().color;
+		if (position >= sorted.back().position)
+			return sorted.back().color;
+
+		const auto next = std::ranges::upper_bound(sorted, position, {}, &ColorStop::position);
+		const auto current = std::prev(next);
+		const float range = next->position - current->position;
+		return glm::mix(current->color, next->color, (position - current->position) / range);
+	}
+
+	std::vector<ColorStop> blendPalettes(const std::vector<ColorStop>& from, const std::vector<ColorStop>& to, float t)
+	{
+		if (from.empty() || to.empty())
+			return t < 1.0F ? from : to;
+
+		std::vector<ColorStop> sortedFrom = from;
+		std::vector<ColorStop> sortedTo = to;
+		std::ranges::sort(sortedFrom);
+		std::ranges::sort(sortedTo);
+
+		std::vector<ColorStop> blended;
+		if (sortedFrom.size() == sortedTo.size())
+		{
+			for (size_t i = 0; i < sortedFrom.size(); ++i)
+			{
+				blended.push_back({ .color = glm::mix(sortedFrom[i].color, sortedTo[i].color, t),
+									.position = std::lerp(sortedFrom[i].position, sortedTo[i].position, t) });
+			}
+			return blended;
+		}
+
+		// Both gradients are piecewise linear, so blending them at every stop of either one is exact in between.
+		for (const ColorStop& stop : sortedFrom)
+		{
+			blended.push_back({ .color = glm::mix(stop.color, evaluatePalette(sortedTo, stop.position), t),
+								.position = stop.position });
+		}
+		for (const ColorStop& stop : sortedTo)
+		{
+			blended.push_back({ .color = glm::mix(evaluatePalette(sortedFrom, stop.position), stop.color, t),
+								.position = stop.position });
+		}
+		std::ranges::stable_sort(blended);
+		const auto duplicates = std::ranges::unique(blended);
+		blended.erase(duplicates.begin(), duplicates.end());
+		return blended;
+	}
+
+	// Share of the way from `from` to `to` the center has moved once the zoom reaches `zoom`, when the two views are
+	// related by a similarity transform.
+	double panWeight(double fromZoom, double toZoom, double zoom)
+	{
+		return (1.0 / zoom - 1.0 / fromZoom) / (1.0 / toZoom - 1.0 / fromZoom);
+	}
+
+	// from + (to - from) * weight, with the weight carried to full double precision however small it is.
+	BigFixed moveToward(const BigFixed& from, const BigFixed& to, double weight, int fractionLimbs)
+	{
+		if (weight <= 0.0)
+			return from.withPrecision(fractionLimbs);
+
+		const int weightLimbs = std::max(fractionLimbs, BigFixed::limbsForBits(WEIGHT_BITS - std::ilogb(weight)));
+		return (from + (to - from) * BigFixed(weight, weightLimbs)).withPrecision(fractionLimbs);
+	}
+
+	BigVec2 interpolateCenter(const FractalState& from, const FractalState& to, double zoom, double t)
+	{
+		const int fractionLimbs = std::max({ from.offset.x.getFractionLimbs(), from.offset.y.getFractionLimbs(),
+											 to.offset.x.getFractionLimbs(), to.offset.y.getFractionLimbs() });
+
+		const bool pan
+			= from.zoom <= 0.0 || to.zoom <= 0.0 || std::abs(to.zoom / from.zoom - 1.0) < SAME_ZOOM_TOLERANCE;
+		const double weight = pan ? t : panWeight(from.zoom, to.zoom, zoom);
+
+		// Deep zooms put the view many orders of magnitude closer to one keyframe than the other, so the offset is
+		// measured from whichever is nearer to keep its rounding below a pixel.
+		if (weight <= 0.5)
+		{
+			return { moveToward(from.offset.x, to.offset.x, weight, fractionLimbs),
+					 moveToward(from.offset.y, to.offset.y, weight, fractionLimbs) };
+		}
+		const double remaining = pan ? 1.0 - t : panWeight(to.zoom, from.zoom, zoom);
+		return { moveToward(to.offset.x, from.offset.x, remaining, fractionLimbs),
+				 moveToward(to.offset.y, from.offset.y, remaining, fractionLimbs) };
+	}
+}
+
+namespace Keyframes
+{
+	double getDuration(const std::vector<Keyframe>& keyframes)
+	{
+		return keyframes.empty() ? 0.0 : keyframes.back().time - keyframes.front().time;
+	}
+
+	int getFrameCount(const std::vector<Keyframe>& keyframes, int framesPerSecond)
+	{
+		if (keyframes.empty() || framesPerSecond <= 0)
+			return 0;
+		return static_cast<int>(std::floor(getDuration(keyframes) * framesPerSecond)) + 1;
+	}
+
+	void apply(const std::vector<Keyframe>& keyframes, double time, FractalState& state)
+	{
+		if (keyframes.empty())
+			return;
+
+		const auto next = std::ranges::upper_bound(keyframes, time, {}, &Keyframe::time);
+		const FractalState& from = (next == keyframes.begin()) ? next->state : std::prev(next)->state;
+		const FractalState& to = (next == keyframes.end()) ? from : next->state;
+
+		state.type = from.type;
+		state.specificParams = from.specificParams;
+		state.coloring = from.coloring;
+		if (&from == &to)
+		{
+			state.offset = from.offset;
+			state.zoom = from.zoom;
+			state.maxIterations = from.maxIterations;
+			return;
+		}
+
+		const double t = (time - std::prev(next)->time) / (next->time - std::prev(next)->time);
+		const bool logZoom = from.zoom > 0.0 && to.zoom > 0.0;
+
+		state.zoom = logZoom ? std::exp(std::lerp(std::log(from.zoom), std::log(to.zoom), t))
+							 : std::lerp(from.zoom, to.zoom, t);
+		state.offset = interpolateCenter(from, to, state.zoom, t);
+		state.maxIterations = static_cast<int>(std::lround(std::lerp(static_cast<double>(from.maxIterations),
+																	 static_cast<double>(to.maxIterations), t)));
+		state.specificParams.juliaConstant = glm::mix(from.specificParams.juliaConstant,
+													  to.specificParams.juliaConstant, t);
+		state.coloring.paletteFrequency = std::lerp(from.coloring.paletteFrequency, to.coloring.paletteFrequency, t);
+		state.coloring.palette = blendPalettes(from.coloring.palette, to.coloring.palette, static_cast<float>(t));
+	}
+}
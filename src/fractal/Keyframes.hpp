@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+#include "FractalState.hpp"
+
+// A view pinned to a point on the animation timeline, in seconds.
+struct Keyframe
+{
+		double time;
+		FractalState state;
+};
+
+// Interpolation between keyframes, which must be sorted by time. Between two keyframes the zoom moves in log space,
+// so every second zooms by the same factor, and the center follows the zoom so the motion is a single similarity
+// transform: the point both views agree on stays put on screen instead of sliding out of a deep zoom. The Julia
+// constant, iteration count and palette frequency move linearly. Palettes with the same number of stops slide stop by
+// stop; otherwise the two gradients crossfade. Everything else, including the fractal type, holds the earlier
+// keyframe's value until the next keyframe is reached.
+namespace Keyframes
+{
+	// Time from the first to the last keyframe.
+	double getDuration(const std::vector<Keyframe>& keyframes);
+
+	// Frames needed to cover the timeline at this rate, both ends included.
+	int getFrameCount(const std::vector<Keyframe>& keyframes, int framesPerSecond);
+
+	// Overwrites the animated fields of `state` (type, view, iterations, fractal parameters and coloring) with the
+	// timeline's value at `time`, clamped to the keyframe range. Size and render settings are left alone. Does nothing
+	// without keyframes.
+	void apply(const std::vector<Keyframe>& keyframes, double time, FractalState& state);
+}
@@ -0,0 +1,61 @@
+#include "PaletteLut.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+namespace
+{
+	// Stops closer together than this are a hard edge rather than a gradient.
+	constexpr float MIN_SEGMENT_WIDTH = 1e-6F;
+}
+
+namespace PaletteLut
+{
+	std::vector<glm::vec3> bake(const std::vector<ColorStop>& stops, int size)
+	{
+		std::vector<glm::vec3> lut(static_cast<size_t>(std::max(size, 2)), glm::vec3(0.0F));
+		if (stops.empty())
+			return lut;
+
+		std::vector<ColorStop> sorted = stops;
+		std::ranges::sort(sorted);
+
+		// Entries are visited in increasing t, so the segment only ever moves forward and baking is linear in
+		// size + stops however long the palette is.
+		size_t segment = 0;
+		const float last = static_cast<float>(lut.size() - 1);
+		for (size_t i = 0; i < lut.size(); ++i)
+		{
+			const float t = static_cast<float>(i) / last;
+			if (t <= sorted.front().position)
+			{
+				lut[i] = sorted.front().color;
+				continue;
+			}
+			if (t >= sorted.back().position)
+			{
+				lut[i] = sorted.back().color;
+				continue;
+			}
+
+			while (segment + 2 < sorted.size() && t > sorted[segment + 1].position)
+				++segment;
+
+			const ColorStop& current = sorted[segment];
+			const ColorStop& next = sorted[segment + 1];
+			const float range = next.position - current.position;
+			const float segmentT = (range < MIN_SEGMENT_WIDTH) ? 0.0F : (t - current.position) / range;
+			lut[i] = glm::mix(current.color, next.color, segmentT);
+		}
+		return lut;
+	}
+
+	glm::vec3 sample(const std::vector<glm::vec3>& lut, float t)
+	{
+		const float x = std::clamp(t, 0.0F, 1.0F) * static_cast<float>(lut.size() - 1);
+		const size_t index = std::min(static_cast<size_t>(x), lut.size() - 2);
+		return glm::mix(lut[index], lut[index + 1], x - static_cast<float>(index));
+	}
+}
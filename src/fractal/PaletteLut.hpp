@@ -0,0 +1,20 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "FractalTypes.hpp"
+
+// The palette gradient baked into evenly spaced samples, so coloring a pixel is one filtered lookup instead of a
+// search through the stops. Entry i holds the color at position i / (size - 1).
+namespace PaletteLut
+{
+	constexpr int DEFAULT_SIZE = 4096;
+
+	// Stops may be in any order; an empty palette bakes to black.
+	std::vector<glm::vec3> bake(const std::vector<ColorStop>& stops, int size = DEFAULT_SIZE);
+
+	// Color at t in [0, 1], interpolated between neighbouring entries like a GL_LINEAR fetch of the same table.
+	glm::vec3 sample(const std::vector<glm::vec3>& lut, float t);
+}
@@ -0,0 +1,82 @@
+#include "ReferenceOrbit.hpp"
+
+#include <chrono>
+
+#include "FractalDefinition.hpp"
+#include "util/Logger.hpp"
+
+namespace
+{
+	// Same bailout as escapeRadius in FractalCommon.glsl.
+	constexpr double ESCAPE_RADIUS_SQ = 16.0;
+}
+
+bool ReferenceOrbit::supports(FractalType type)
+{
+	return type == FractalType::Mandelbrot || type == FractalType::Tricorn || type == FractalType::BurningShip;
+}
+
+bool ReferenceOrbit::update(FractalType type, const BigFixed& centerX, const BigFixed& centerY, double zoom,
+							int viewHeight, int maxIterations)
+{
+	const int fractionLimbs = BigFixed::limbsForResolution(zoom * static_cast<double>(viewHeight));
+
+	// Zooming out never needs a recompute; zooming in only once the current precision runs out.
+	const bool sameView = type == m_type && maxIterations == m_maxIterations && centerX == m_centerX
+						  && centerY == m_centerY && fractionLimbs <= m_fractionLimbs && !m_points.empty();
+	if (sameView)
+		return false;
+
+	m_type = type;
+	m_centerX = centerX.withPrecision(fractionLimbs);
+	m_centerY = centerY.withPrecision(fractionLimbs);
+	m_maxIterations = maxIterations;
+	m_fractionLimbs = fractionLimbs;
+	compute();
+	return true;
+}
+
+void ReferenceOrbit::compute()
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	m_points.clear();
+	m_points.reserve(static_cast<size_t>(m_maxIterations) + 1);
+	m_points.emplace_back(0.0, 0.0);
+
+	BigFixed x(0.0, m_fractionLimbs);
+	BigFixed y(0.0, m_fractionLimbs);
+
+	for (int i = 0; i < m_maxIterations; ++i)
+	{
+		const BigFixed xx = x.square();
+		const BigFixed yy = y.square();
+		const BigFixed xy = x * y;
+
+		BigFixed nextY;
+		switch (m_type)
+		{
+			case FractalType::Tricorn:
+				nextY = m_centerY - xy * 2;
+				break;
+			case FractalType::BurningShip:
+				nextY = xy.abs() * 2 + m_centerY;
+				break;
+			default:
+				nextY = xy * 2 + m_centerY;
+				break;
+		}
+		x = xx - yy + m_centerX;
+		y = nextY;
+
+		const glm::dvec2 point(x.toDouble(), y.toDouble());
+		m_points.push_back(point);
+		if (point.x * point.x + point.y * point.y > ESCAPE_RADIUS_SQ)
+			break;
+	}
+
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	m_computeMilliseconds = elapsed.count();
+	FRACTAL_TRACE("Reference orbit for '{}': {} iterations at {} bits in {:.1f} ms.", FractalDefinitions.at(m_type).name,
+				 getLength(), getPrecisionBits(), m_computeMilliseconds);
+}
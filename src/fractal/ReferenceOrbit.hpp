@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "FractalTypes.hpp"
+#include "util/BigFixed.hpp"
+
+// High-precision orbit of the view center, the reference that perturbation rendering iterates pixel deltas
+// against. Points are rounded to double after each full-precision step, which is all the per-pixel delta
+// iteration needs. The orbit is only recomputed when the center, fractal, iteration cap or required
+// precision changes, so panning at a fixed zoom still pays for it once per frame but recoloring does not.
+class ReferenceOrbit
+{
+	public:
+		// Returns true when the orbit had to be recomputed.
+		bool update(FractalType type, const BigFixed& centerX, const BigFixed& centerY, double zoom, int viewHeight,
+					int maxIterations);
+
+		[[nodiscard]] const std::vector<glm::dvec2>& getPoints() const { return m_points; }
+		// Index of the last stored point; the orbit either escaped there or reached maxIterations.
+		[[nodiscard]] int getLength() const { return static_cast<int>(m_points.size()) - 1; }
+		[[nodiscard]] int getPrecisionBits() const { return m_fractionLimbs * BigFixed::LIMB_BITS; }
+		[[nodiscard]] double getComputeMilliseconds() const { return m_computeMilliseconds; }
+
+		static bool supports(FractalType type);
+
+	private:
+		void compute();
+
+		FractalType m_type = FractalType::Mandelbrot;
+		BigFixed m_centerX;
+		BigFixed m_centerY;
+		int m_maxIterations = 0;
+		int m_fractionLimbs = 0;
+
+		std::vector<glm::dvec2> m_points;
+		double m_computeMilliseconds = 0.0;
+};
@@ -0,0 +1,161 @@
+#include "Supersampling.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "ViewRegion.hpp"
+
+namespace
+{
+	constexpr int RESOLVE_ROWS_PER_TASK = 16;
+	constexpr double MITCHELL_B = 1.0 / 3.0;
+	constexpr double MITCHELL_C = 1.0 / 3.0;
+	constexpr double LANCZOS_LOBES = 3.0;
+
+	// Reach of the filter in output pixels, measured from the pixel center.
+	double getRadius(ResolveFilter filter)
+	{
+		switch (filter)
+		{
+			case ResolveFilter::Mitchell:
+				return 2.0;
+			case ResolveFilter::Lanczos:
+				return LANCZOS_LOBES;
+			case ResolveFilter::Box:
+				break;
+		}
+		return 0.5;
+	}
+
+	double mitchell(double x)
+	{
+		constexpr double B = MITCHELL_B;
+		constexpr double C = MITCHELL_C;
+		x = std::abs(x);
+		if (x < 1.0)
+		{
+			return (((12.0 - (9.0 * B) - (6.0 * C)) * x * x * x) + ((-18.0 + (12.0 * B) + (6.0 * C)) * x * x)
+					+ (6.0 - (2.0 * B)))
+				   / 6.0;
+		}
+		if (x < 2.0)
+		{
+			return (((-B - (6.0 * C)) * x * x * x) + (((6.0 * B) + (30.0 * C)) * x * x)
+					+ (((-12.0 * B) - (48.0 * C)) * x) + ((8.0 * B) + (24.0 * C)))
+				   / 6.0;
+		}
+		return 0.0;
+	}
+
+	double sinc(double x)
+	{
+		if (x == 0.0)
+			return 1.0;
+		const double px = std::numbers::pi * x;
+		return std::sin(px) / px;
+	}
+
+	double evaluate(ResolveFilter filter, double x)
+	{
+		switch (filter)
+		{
+			case ResolveFilter::Mitchell:
+				return mitchell(x);
+			case ResolveFilter::Lanczos:
+				return std::abs(x) < LANCZOS_LOBES ? sinc(x) * sinc(x / LANCZOS_LOBES) : 0.0;
+			case ResolveFilter::Box:
+				break;
+		}
+		return std::abs(x) <= 0.5 ? 1.0 : 0.0;
+	}
+}
+
+namespace Supersampling
+{
+	int getMargin(ResolveFilter filter)
+	{
+		return static_cast<int>(std::ceil(getRadius(filter) - 0.5));
+	}
+
+	std::vector<float> getWeights(ResolveFilter filter, int factor)
+	{
+		// Tap k sits at (k + 0.5) / factor - 0.5 - margin output pixels from the center of the pixel it serves.
+		const int margin = getMargin(filter);
+		std::vector<double> weights(static_cast<size_t>(((2 * margin) + 1) * factor));
+		double sum = 0.0;
+		for (size_t k = 0; k < weights.size(); ++k)
+		{
+			const double position = ((static_cast<double>(k) + 0.5) / factor) - 0.5 - margin;
+			weights[k] = evaluate(filter, position);
+			sum += weights[k];
+		}
+
+		std::vector<float> normalized(weights.size());
+		std::ranges::transform(weights, normalized.begin(),
+							   [sum](double weight) { return static_cast<float>(weight / sum); });
+		return normalized;
+	}
+
+	FractalState getSampleView(const FractalState& view, int factor, ResolveFilter filter)
+	{
+		// Sample j lies at -margin - 0.5 + (j + 0.5) / factor, which centers each pixel's samples on the point an
+		// unsupersampled render would take, so anti-aliasing does not shift the image.
+		const int margin = getMargin(filter);
+		const double origin = -margin - 0.5 + (0.5 / factor);
+		FractalState samples = ViewRegion::crop(view, origin, origin, view.renderWidth + (2.0 * margin),
+												view.renderHeight + (2.0 * margin));
+		samples.renderWidth = (view.renderWidth + (2 * margin)) * factor;
+		samples.renderHeight = (view.renderHeight + (2 * margin)) * factor;
+		return samples;
+	}
+
+	std::vector<uint8_t> resolve(TaskScheduler& scheduler, const std::vector<uint8_t>& samples, int width,
+								 int height, int factor, ResolveFilter filter)
+	{
+		const std::vector<float> weights = getWeights(filter, factor);
+		const int taps = static_cast<int>(weights.size());
+		const int margin = getMargin(filter);
+		const size_t sampleWidth = static_cast<size_t>(width + (2 * margin)) * static_cast<size_t>(factor);
+		const int sampleHeight = (height + (2 * margin)) * factor;
+		const size_t rowPitch = static_cast<size_t>(width) * 4;
+		const auto rowTasks = [](int rows) { return (rows + RESOLVE_ROWS_PER_TASK - 1) / RESOLVE_ROWS_PER_TASK; };
+
+		// Horizontal pass into full precision, then vertical; both are separable sums over `taps` samples.
+		std::vector<float> columns(static_cast<size_t>(sampleHeight) * rowPitch);
+		scheduler.parallelFor(rowTasks(sampleHeight), [&](int task) {
+			const int lastRow = std::min(sampleHeight, (task + 1) * RESOLVE_ROWS_PER_TASK);
+			for (int y = task * RESOLVE_ROWS_PER_TASK; y < lastRow; ++y)
+			{
+				const uint8_t* source = samples.data() + (static_cast<size_t>(y) * sampleWidth * 4);
+				float* target = columns.data() + (static_cast<size_t>(y) * rowPitch);
+				for (int x = 0; x < width; ++x)
+				{
+					const uint8_t* first = source + (static_cast<size_t>(x) * factor * 4);
+					for (int k = 0; k < taps; ++k)
+					{
+						for (int channel = 0; channel < 4; ++channel)
+							target[(x * 4) + channel] += weights[k] * first[(k * 4) + channel];
+					}
+				}
+			}
+		});
+
+		std::vector<uint8_t> pixels(static_cast<size_t>(height) * rowPitch);
+		scheduler.parallelFor(rowTasks(height), [&](int task) {
+			const int lastRow = std::min(height, (task + 1) * RESOLVE_ROWS_PER_TASK);
+			for (int y = task * RESOLVE_ROWS_PER_TASK; y < lastRow; ++y)
+			{
+				uint8_t* target = pixels.data() + (static_cast<size_t>(y) * rowPitch);
+				for (size_t i = 0; i < rowPitch; ++i)
+				{
+					float sum = 0.0F;
+					for (int k = 0; k < taps; ++k)
+						sum += weights[k] * columns[(static_cast<size_t>((y * factor) + k) * rowPitch) + i];
+					target[i] = static_cast<uint8_t>(std::clamp(std::lround(sum), 0L, 255L));
+				}
+			}
+		});
+		return pixels;
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "FractalState.hpp"
+#include "core/TaskScheduler.hpp"
+#include "ui/UIState.hpp"
+
+// Anti-aliasing for exports: the view is rendered with a factor x factor grid of samples inside every output pixel
+// and filtered down to the output size. The sample grid reaches getMargin() output pixels past the image on every
+// side, so filters wider than a pixel see real samples at the edges, and tiles resolved separately join without
+// seams. Since the grid is regular, every output pixel uses the same weights, computed once per resolve.
+namespace Supersampling
+{
+	// Largest factor the GPU resolve is sized for.
+	constexpr int MAX_FACTOR = 8;
+	// Weights of the widest filter at MAX_FACTOR; ResolveShader.glsl declares its weight array this long.
+	constexpr int MAX_TAPS = 56;
+
+	// Output pixels the filter reaches beyond the one it resolves.
+	int getMargin(ResolveFilter filter);
+
+	// Weights along one axis: output pixel p is the sum of weights[k] * sample[p * factor + k]. They sum to 1.
+	std::vector<float> getWeights(ResolveFilter filter, int factor);
+
+	// The sample grid of `view` as a view of its own, sized (renderWidth + 2 * margin) * factor by
+	// (renderHeight + 2 * margin) * factor.
+	FractalState getSampleView(const FractalState& view, int factor, ResolveFilter filter);
+
+	// Filters RGBA8 samples of getSampleView() down to width x height pixels on the worker pool, keeping their row
+	// order. The GPU backend does the same in ResolveShader.glsl before reading the image back.
+	std::vector<uint8_t> resolve(TaskScheduler& scheduler, const std::vector<uint8_t>& samples, int width,
+								 int height, int factor, ResolveFilter filter);
+}
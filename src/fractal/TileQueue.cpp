@@ -0,0 +1,163 @@
+#include "TileQueue.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+
+namespace
+{
+	constexpr GLuint TILE_QUEUE_BINDING = 3;
+	constexpr GLuint TILE_COST_BINDING = 4;
+
+	int ceilDiv(int value, int divisor)
+	{
+		return (value + divisor - 1) / divisor;
+	}
+}
+
+TileQueue::TileQueue()
+{
+	glGenBuffers(1, &m_queueSSBO);
+	glGenBuffers(1, &m_costSSBO);
+	glGenBuffers(1, &m_costReadBuffer);
+}
+
+TileQueue::~TileQueue()
+{
+	if (m_costFence != nullptr)
+		glDeleteSync(m_costFence);
+	glDeleteBuffers(1, &m_queueSSBO);
+	glDeleteBuffers(1, &m_costSSBO);
+	glDeleteBuffers(1, &m_costReadBuffer);
+}
+
+void TileQueue::resize(int width, int height)
+{
+	m_width = width;
+	m_height = height;
+	layOutGrids();
+}
+
+void TileQueue::layOutGrids()
+{
+	int cellCount = 0;
+	for (int level = 0; level < LEVEL_COUNT; ++level)
+	{
+		const glm::ivec2 tilePixels = m_tileSamples * (1 << level);
+		m_levelOffsets[static_cast<size_t>(level)] = cellCount;
+		m_levelColumns[static_cast<size_t>(level)] = ceilDiv(m_width, tilePixels.x);
+		cellCount += ceilDiv(m_width, tilePixels.x) * ceilDiv(m_height, tilePixels.y);
+	}
+	m_costs.assign(static_cast<size_t>(cellCount), 0.0F);
+
+	if (m_costFence != nullptr)
+	{
+		glDeleteSync(m_costFence);
+		m_costFence = nullptr;
+	}
+	const auto size = static_cast<GLsizeiptr>(m_costs.size() * sizeof(float));
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_costSSBO);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, size, m_costs.data(), GL_DYNAMIC_COPY);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_costReadBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_STREAM_READ);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+int TileQueue::prepare(const Shader& shader, int width, int height, glm::ivec2 origin, glm::ivec2 size, int stride,
+					   glm::ivec2 tileSamples, bool useCosts)
+{
+	if (tileSamples != m_tileSamples)
+	{
+		m_tileSamples = tileSamples;
+		layOutGrids();
+	}
+
+	const int tileColumns = ceilDiv(ceilDiv(size.x, stride), tileSamples.x);
+	const int tileCount = tileColumns * ceilDiv(ceilDiv(size.y, stride), tileSamples.y);
+	const int level = std::countr_zero(static_cast<unsigned>(stride));
+	const bool recordCosts = useCosts && width == m_width && height == m_height
+							 && std::has_single_bit(static_cast<unsigned>(stride)) && level < LEVEL_COUNT;
+
+	// The first word is the counter the workgroups take tiles from.
+	std::vector<GLuint> queue(1, 0);
+	if (!recordCosts)
+	{
+		queue.resize(static_cast<size_t>(tileCount) + 1);
+		std::iota(queue.begin() + 1, queue.end(), 0U);
+	}
+	else
+	{
+		const glm::ivec2 tilePixels = tileSamples * stride;
+		const int levelOffset = m_levelOffsets[static_cast<size_t>(level)];
+		const int levelColumns = m_levelColumns[static_cast<size_t>(level)];
+		std::vector<float> tileCosts(static_cast<size_t>(tileCount));
+		for (int tile = 0; tile < tileCount; ++tile)
+		{
+			const glm::ivec2 cell = (origin + (glm::ivec2{ tile % tileColumns, tile / tileColumns } * tilePixels))
+									/ tilePixels;
+			tileCosts[static_cast<size_t>(tile)] = m_costs[static_cast<size_t>(levelOffset + (cell.y * levelColumns)
+																			   + cell.x)];
+		}
+		const std::vector<GLuint> order = orderByCost(tileCosts);
+		queue.insert(queue.end(), order.begin(), order.end());
+	}
+
+	// Respecifying the storage lets the driver hand out a fresh buffer while earlier dispatches still read the last.
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_queueSSBO);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(queue.size() * sizeof(GLuint)), queue.data(),
+				 GL_STREAM_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TILE_QUEUE_BINDING, m_queueSSBO);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TILE_COST_BINDING, m_costSSBO);
+
+	shader.setInt("tileColumns", tileColumns);
+	shader.setInt("tileCount", tileCount);
+	shader.setInt("costLevelOffset", recordCosts ? m_levelOffsets[static_cast<size_t>(level)] : 0);
+	shader.setInt("costLevelColumns", recordCosts ? m_levelColumns[static_cast<size_t>(level)] : 0);
+	return tileCount;
+}
+
+std::vector<GLuint> TileQueue::orderByCost(const std::vector<float>& tileCosts)
+{
+	std::vector<GLuint> order(tileCosts.size());
+	std::iota(order.begin(), order.end(), 0U);
+	std::stable_sort(order.begin(), order.end(), [&](GLuint a, GLuint b) { return tileCosts[a] > tileCosts[b]; });
+	return order;
+}
+
+void TileQueue::updateCosts(bool wait)
+{
+	if (m_costFence != nullptr)
+	{
+		const GLenum status = glClientWaitSync(m_costFence, 0, 0);
+		if (!wait && status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+			return;
+		finishCostCopy();
+	}
+	if (m_costs.empty())
+		return;
+
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+	glBindBuffer(GL_COPY_READ_BUFFER, m_costSSBO);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, m_costReadBuffer);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+						static_cast<GLsizeiptr>(m_costs.size() * sizeof(float)));
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	m_costFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glFlush();
+
+	if (wait)
+		finishCostCopy();
+}
+
+void TileQueue::finishCostCopy()
+{
+	// Reading the buffer waits for the copy if it has not landed yet.
+	glDeleteSync(m_costFence);
+	m_costFence = nullptr;
+	glBindBuffer(GL_COPY_READ_BUFFER, m_costReadBuffer);
+	glGetBufferSubData(GL_COPY_READ_BUFFER, 0, static_cast<GLsizeiptr>(m_costs.size() * sizeof(float)),
+					   m_costs.data());
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <glad/gl.h>
+#include <glm/vec2.hpp>
+
+#include "gfx/Shader.hpp"
+
+// Work queue of the persistent-thread mode of MainShader.glsl. Each dispatch lists its tiles most expensive first,
+// going by the iterations they took the last time they were rendered at the same stride. The kernel records those
+// costs in a grid per stride, which is copied back to the CPU in the background and used from the next frame on.
+class TileQueue
+{
+	public:
+		TileQueue();
+		~TileQueue();
+
+		TileQueue(const TileQueue&) = delete;
+		TileQueue& operator=(const TileQueue&) = delete;
+		TileQueue(TileQueue&&) = delete;
+		TileQueue& operator=(TileQueue&&) = delete;
+
+		// Sizes the cost grids for the interactive view and forgets the costs measured so far.
+		void resize(int width, int height);
+		// Queues the tiles of a pass over [origin, origin + size) of a width x height target at `stride`, binds the
+		// queue and sets its uniforms on `shader`. A tile is the `tileSamples` one workgroup of the shader takes; when
+		// that changes, the cost grids are laid out anew. Passes over the view on screen set `useCosts`: they are
+		// ordered by and record costs, while exports and animation frames of the same size are queued in row order
+		// and leave the grids alone. Returns the number of tiles.
+		int prepare(const Shader& shader, int width, int height, glm::ivec2 origin, glm::ivec2 size, int stride,
+					glm::ivec2 tileSamples, bool useCosts);
+		// Takes in the costs of a finished copy and starts the next one. Only blocks with `wait`, which also waits for
+		// the copy it starts.
+		void updateCosts(bool wait = false);
+
+		// Tile indices in the order the workgroups take them: most expensive first, tiles that were never measured
+		// (cost 0) last and in row order.
+		[[nodiscard]] static std::vector<GLuint> orderByCost(const std::vector<float>& tileCosts);
+
+	private:
+		// One cost grid for every stride the progressive passes use, 1 to 64.
+		static constexpr int LEVEL_COUNT = 7;
+
+		// Sizes the grids for the current view and tile and clears them.
+		void layOutGrids();
+		void finishCostCopy();
+
+		int m_width = 0;
+		int m_height = 0;
+		glm::ivec2 m_tileSamples{ 16, 16 };
+		std::array<int, LEVEL_COUNT> m_levelOffsets{};
+		std::array<int, LEVEL_COUNT> m_levelColumns{};
+		std::vector<float> m_costs; // CPU copy of the grids, a frame or more behind the GPU.
+
+		GLuint m_queueSSBO = 0;
+		GLuint m_costSSBO = 0;
+		GLuint m_costReadBuffer = 0;
+		GLsync m_costFence = nullptr;
+};
@@ -0,0 +1,29 @@
+#include "ViewRegion.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ViewRegion
+{
+	FractalState crop(const FractalState& view, double x, double y, double width, double height)
+	{
+		const double fullWidth = view.renderWidth;
+		const double fullHeight = view.renderHeight;
+		const double pixelsPerUnit = view.zoom * fullHeight;
+
+		// MainShader maps pixel p of a w x h image to offset + ((p.x - w / 2) / h, (h / 2 - p.y) / h) / zoom, so
+		// the rectangle's center moves the offset and the ratio of the heights scales the zoom.
+		const double shiftX = (x + (width * 0.5) - (fullWidth * 0.5)) / pixelsPerUnit;
+		const double shiftY = ((fullHeight * 0.5) - y - (height * 0.5)) / pixelsPerUnit;
+
+		FractalState region = view;
+		region.renderWidth = static_cast<int>(std::lround(width));
+		region.renderHeight = static_cast<int>(std::lround(height));
+		region.zoom = view.zoom * fullHeight / height;
+
+		const int limbs = std::max(view.offset.x.getFractionLimbs(), BigFixed::limbsForResolution(pixelsPerUnit));
+		region.offset.x = view.offset.x.withPrecision(limbs) + BigFixed(shiftX, limbs);
+		region.offset.y = view.offset.y.withPrecision(limbs) + BigFixed(shiftY, limbs);
+		return region;
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "FractalState.hpp"
+
+// Sub-views of a view, for rendering part of an image or resampling it at a different pixel density.
+namespace ViewRegion
+{
+	// The view that shows the rectangle (x, y, width, height) of `view`'s renderWidth x renderHeight pixel grid in
+	// its own frame, measured in pixels from the top-left corner in texture rows (row 0 is the top of the complex
+	// plane, as MainShader stores it). Coordinates may be fractional and reach outside the grid. Rendered at any
+	// size with the aspect ratio of the rectangle, pixel (i, j) of the result samples the point that pixel
+	// (x + i * width / w, y + j * height / h) of the full grid would. Its renderWidth and renderHeight are the
+	// rectangle's, rounded; callers rendering it at another density set their own.
+	FractalState crop(const FractalState& view, double x, double y, double width, double height);
+}
@@ -0,0 +1,377 @@
+#include "CpuFractalRenderer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#if defined(FRACTAVISTA_HAS_X86_SIMD) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+#include "fractal/PaletteLut.hpp"
+#include "util/Logger.hpp"
+
+namespace
+{
+	enum class CpuIsa
+	{
+		Scalar,
+		AVX2,
+		AVX512
+	};
+
+	CpuIsa detectCpuIsa()
+	{
+#if defined(FRACTAVISTA_HAS_X86_SIMD) && defined(_MSC_VER)
+		std::array<int, 4> info{};
+		__cpuid(info.data(), 0);
+		if (info[0] < 7)
+			return CpuIsa::Scalar;
+
+		__cpuid(info.data(), 1);
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+		const bool fma = (info[2] & (1 << 12)) != 0;
+		if (!osxsave || !avx)
+			return CpuIsa::Scalar;
+
+		// The OS must save the YMM (and for AVX-512 also the opmask/ZMM) state across context switches.
+		const unsigned long long xcr0 = _xgetbv(0);
+		const bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+		const bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+
+		__cpuidex(info.data(), 7, 0);
+		const bool avx2 = (info[1] & (1 << 5)) != 0;
+		const bool avx512f = (info[1] & (1 << 16)) != 0;
+
+		if (avx512f && zmmEnabled)
+			return CpuIsa::AVX512;
+		if (avx2 && fma && ymmEnabled)
+			return CpuIsa::AVX2;
+#elif defined(FRACTAVISTA_HAS_X86_SIMD)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f"))
+			return CpuIsa::AVX512;
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+			return CpuIsa::AVX2;
+#endif
+		return CpuIsa::Scalar;
+	}
+
+	// Small square tiles keep the per-tile cost variance low enough for stealing to even out the workers.
+	constexpr int TILE_SIZE = 32;
+	constexpr int COLORIZE_ROWS_PER_TASK = 16;
+	// Iteration values further apart than this count as a mismatch when validating iteration skipping.
+	constexpr double VALIDATION_TOLERANCE = 0.01;
+	// Rectangles whose inside is narrower or shorter than this are iterated directly instead of split further.
+	constexpr int MIN_SUBDIVISION_SIZE = 4;
+	// Band of pixels that never escaped, stored as 0 like anything else colorize() paints black.
+	constexpr int INTERIOR_BAND = -1;
+
+	// Whole iteration count of a pixel, the dwell band Mariani-Silver compares borders by. Smoothed values of one band
+	// differ in their fraction, so comparing them for equality would only ever match the interior.
+	int dwellBand(float iterations)
+	{
+		return iterations > 0.0F ? static_cast<int>(iterations) : INTERIOR_BAND;
+	}
+
+	uint8_t toUnorm8(float value)
+	{
+		return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0F, 1.0F) * 255.0F));
+	}
+}
+
+CpuFractalRenderer::CpuFractalRenderer(TaskScheduler& scheduler) : m_scheduler(scheduler)
+{
+	switch (detectCpuIsa())
+	{
+#if defined(FRACTAVISTA_HAS_X86_SIMD)
+		case CpuIsa::AVX512:
+			m_kernel = CpuKernels::renderTileAVX512;
+			m_isaName = "AVX-512";
+			break;
+		case CpuIsa::AVX2:
+			m_kernel = CpuKernels::renderTileAVX2;
+			m_isaName = "AVX2";
+			break;
+#endif
+		default:
+			m_kernel = CpuKernels::renderTileScalar;
+			m_isaName = "Scalar";
+			break;
+	}
+
+	FRACTAL_INFO("CPU renderer using {} kernels on {} workers.", m_isaName, m_scheduler.getWorkerCount());
+}
+
+CpuKernels::KernelParams CpuFractalRenderer::makeParams(const FractalState& state, int width, int height,
+														const ReferenceOrbit* reference, const BlaTable* bla)
+{
+	CpuKernels::KernelParams params;
+	params.type = state.type;
+	params.width = width;
+	params.height = height;
+	params.offsetX = state.offset.x.toDouble();
+	params.offsetY = state.offset.y.toDouble();
+	params.zoom = state.zoom;
+	params.maxIterations = state.maxIterations;
+	params.useSmoothing = state.coloring.useSmoothing;
+	params.juliaX = state.specificParams.juliaConstant.x;
+	params.juliaY = state.specificParams.juliaConstant.y;
+	if (reference != nullptr)
+	{
+		params.referenceOrbit = reference->getPoints().data();
+		params.referenceLength = reference->getLength();
+	}
+	if (reference != nullptr && bla != nullptr && !bla->isEmpty())
+	{
+		params.blaSteps = bla->getSteps().data();
+		params.blaLevelCount = bla->getLevelCount();
+	}
+	return params;
+}
+
+void CpuFractalRenderer::render(const FractalState& state, int width, int height, std::vector<uint8_t>& rgba,
+								const ReferenceOrbit* reference, const BlaTable* bla)
+{
+	const auto start = std::chrono::steady_clock::now();
+	m_scheduler.resetStats();
+
+	const bool subdivide = state.useRectangleSubdivision && supportsSubdivision(state.type);
+	const size_t filled = computeIterations(makeParams(state, width, height, reference, bla), m_iterations, subdivide);
+	colorize(state.coloring, width, height, rgba);
+
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	m_lastStats.milliseconds = elapsed.count();
+	m_lastStats.megapixelsPerSecond
+		= (static_cast<double>(width) * static_cast<double>(height)) / (std::max(elapsed.count(), 1e-3) * 1000.0);
+	m_lastStats.filledPixelRatio
+		= static_cast<double>(filled) / (static_cast<double>(width) * static_cast<double>(height));
+	m_lastStats.workers = m_scheduler.getWorkerStats();
+}
+
+bool CpuFractalRenderer::recolor(const ColoringParams& coloring, int width, int height, std::vector<uint8_t>& rgba)
+{
+	if (m_iterations.size() != static_cast<size_t>(width) * static_cast<size_t>(height))
+		return false;
+
+	const auto start = std::chrono::steady_clock::now();
+	colorize(coloring, width, height, rgba);
+
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	m_lastStats.milliseconds = elapsed.count();
+	return true;
+}
+
+IterationSkippingReport CpuFractalRenderer::compareIterationSkipping(const FractalState& state, int width, int height,
+																	 const ReferenceOrbit& reference,
+																	 const BlaTable& bla)
+{
+	std::vector<float> full;
+	std::vector<float> skipped;
+	std::vector<CpuKernels::IterationCounts> tileCounts;
+
+	computeIterations(makeParams(state, width, height, &reference, nullptr), full);
+	computeIterations(makeParams(state, width, height, &reference, &bla), skipped, false, &tileCounts);
+
+	IterationSkippingReport report;
+	report.valid = true;
+	report.width = width;
+	report.height = height;
+
+	size_t mismatched = 0;
+	for (size_t i = 0; i < full.size(); ++i)
+	{
+		const double difference = std::abs(static_cast<double>(full[i]) - static_cast<double>(skipped[i]));
+		report.maxDifference = std::max(report.maxDifference, difference);
+		if (difference > VALIDATION_TOLERANCE)
+			++mismatched;
+	}
+	report.mismatchedPixelRatio = full.empty() ? 0.0 : static_cast<double>(mismatched) / static_cast<double>(full.size());
+
+	uint64_t stepped = 0;
+	uint64_t skippedIterations = 0;
+	for (const CpuKernels::IterationCounts& counts : tileCounts)
+	{
+		stepped += counts.stepped;
+		skippedIterations += counts.skipped;
+	}
+	const uint64_t total = stepped + skippedIterations;
+	report.skippedIterationRatio
+		= total > 0 ? static_cast<double>(skippedIterations) / static_cast<double>(total) : 0.0;
+	return report;
+}
+
+size_t CpuFractalRenderer::computeIterations(const CpuKernels::KernelParams& params, std::vector<float>& iterations,
+											 bool subdivide, std::vector<CpuKernels::IterationCounts>* tileCounts)
+{
+	iterations.resize(static_cast<size_t>(params.width) * static_cast<size_t>(params.height));
+
+	const int tilesX = (params.width + TILE_SIZE - 1) / TILE_SIZE;
+	const int tilesY = (params.height + TILE_SIZE - 1) / TILE_SIZE;
+	if (tileCounts != nullptr)
+		tileCounts->assign(static_cast<size_t>(tilesX) * static_cast<size_t>(tilesY), {});
+	std::vector<size_t> tileFilled(subdivide ? static_cast<size_t>(tilesX) * static_cast<size_t>(tilesY) : 0, 0);
+
+	m_scheduler.parallelFor(tilesX * tilesY, [&](int tileIndex) {
+		const int x = (tileIndex % tilesX) * TILE_SIZE;
+		const int y = (tileIndex / tilesX) * TILE_SIZE;
+		const CpuKernels::TileRect tile{ .x = x,
+										 .y = y,
+										 .width = std::min(TILE_SIZE, params.width - x),
+										 .height = std::min(TILE_SIZE, params.height - y) };
+
+		CpuKernels::KernelParams tileParams = params;
+		if (tileCounts != nullptr)
+			tileParams.counts = &(*tileCounts)[static_cast<size_t>(tileIndex)];
+		if (subdivide)
+			tileFilled[static_cast<size_t>(tileIndex)] = renderTileSubdivided(tileParams, tile, iterations.data());
+		else
+			m_kernel(tileParams, tile, iterations.data());
+	});
+
+	size_t filled = 0;
+	for (const size_t count : tileFilled)
+		filled += count;
+	return filled;
+}
+
+// Mariani-Silver: only the border of the tile is iterated up front; subdivide() then works inwards.
+size_t CpuFractalRenderer::renderTileSubdivided(const CpuKernels::KernelParams& params,
+												const CpuKernels::TileRect& tile, float* iterations) const
+{
+	const int right = tile.x + tile.width - 1;
+	const int bottom = tile.y + tile.height - 1;
+
+	m_kernel(params, { .x = tile.x, .y = tile.y, .width = tile.width, .height = 1 }, iterations);
+	if (tile.height > 1)
+		m_kernel(params, { .x = tile.x, .y = bottom, .width = tile.width, .height = 1 }, iterations);
+	if (tile.height > 2)
+	{
+		m_kernel(params, { .x = tile.x, .y = tile.y + 1, .width = 1, .height = tile.height - 2 }, iterations);
+		if (tile.width > 1)
+			m_kernel(params, { .x = right, .y = tile.y + 1, .width = 1, .height = tile.height - 2 }, iterations);
+	}
+	return subdivide(params, tile, iterations);
+}
+
+// `rect`'s one-pixel border is already computed. Since the set and its dwell bands are connected, a border that lies
+// in a single band (the interior, or one whole iteration count) encloses only that band, so the inside is filled
+// without iterating: blended from the border so smooth coloring stays smooth, and exact when the values are integers.
+// Otherwise a cross through the middle is computed and the four quarters, whose borders are now known, are handled
+// the same way.
+size_t CpuFractalRenderer::subdivide(const CpuKernels::KernelParams& params, const CpuKernels::TileRect& rect,
+									 float* iterations) const
+{
+	const int innerWidth = rect.width - 2;
+	const int innerHeight = rect.height - 2;
+	if (innerWidth <= 0 || innerHeight <= 0)
+		return 0;
+
+	const size_t pitch = static_cast<size_t>(params.width);
+	const auto at = [&](int x, int y) -> float& {
+		return iterations[(static_cast<size_t>(y) * pitch) + static_cast<size_t>(x)];
+	};
+
+	const int right = rect.x + rect.width - 1;
+	const int bottom = rect.y + rect.height - 1;
+	const int band = dwellBand(at(rect.x, rect.y));
+	bool uniform = true;
+	for (int x = rect.x; x <= right && uniform; ++x)
+		uniform = dwellBand(at(x, rect.y)) == band && dwellBand(at(x, bottom)) == band;
+	for (int y = rect.y + 1; y < bottom && uniform; ++y)
+		uniform = dwellBand(at(rect.x, y)) == band && dwellBand(at(right, y)) == band;
+
+	if (uniform)
+	{
+		if (band == INTERIOR_BAND)
+		{
+			for (int y = rect.y + 1; y < bottom; ++y)
+				std::fill_n(&at(rect.x + 1, y), innerWidth, 0.0F);
+			return static_cast<size_t>(innerWidth) * static_cast<size_t>(innerHeight);
+		}
+
+		// The mean of the row and column blends of the border; the clamp only catches float rounding at the band's
+		// upper edge.
+		const float lowest = static_cast<float>(band);
+		const float highest = std::nextafter(static_cast<float>(band + 1), 0.0F);
+		const float invWidth = 1.0F / static_cast<float>(rect.width - 1);
+		const float invHeight = 1.0F / static_cast<float>(rect.height - 1);
+		for (int y = rect.y + 1; y < bottom; ++y)
+		{
+			const float ty = static_cast<float>(y - rect.y) * invHeight;
+			for (int x = rect.x + 1; x < right; ++x)
+			{
+				const float tx = static_cast<float>(x - rect.x) * invWidth;
+				const float across = std::lerp(at(rect.x, y), at(right, y), tx);
+				const float down = std::lerp(at(x, rect.y), at(x, bottom), ty);
+				at(x, y) = std::clamp(0.5F * (across + down), lowest, highest);
+			}
+		}
+		return static_cast<size_t>(innerWidth) * static_cast<size_t>(innerHeight);
+	}
+
+	if (innerWidth < MIN_SUBDIVISION_SIZE || innerHeight < MIN_SUBDIVISION_SIZE)
+	{
+		m_kernel(params, { .x = rect.x + 1, .y = rect.y + 1, .width = innerWidth, .height = innerHeight },
+				 iterations);
+		return 0;
+	}
+
+	const int midX = rect.x + (rect.width / 2);
+	const int midY = rect.y + (rect.height / 2);
+	m_kernel(params, { .x = rect.x + 1, .y = midY, .width = innerWidth, .height = 1 }, iterations);
+	m_kernel(params, { .x = midX, .y = rect.y + 1, .width = 1, .height = midY - rect.y - 1 }, iterations);
+	m_kernel(params, { .x = midX, .y = midY + 1, .width = 1, .height = bottom - midY - 1 }, iterations);
+
+	const int leftWidth = midX - rect.x + 1;
+	const int rightWidth = right - midX + 1;
+	const int topHeight = midY - rect.y + 1;
+	const int bottomHeight = bottom - midY + 1;
+	return subdivide(params, { .x = rect.x, .y = rect.y, .width = leftWidth, .height = topHeight }, iterations)
+		   + subdivide(params, { .x = midX, .y = rect.y, .width = rightWidth, .height = topHeight }, iterations)
+		   + subdivide(params, { .x = rect.x, .y = midY, .width = leftWidth, .height = bottomHeight }, iterations)
+		   + subdivide(params, { .x = midX, .y = midY, .width = rightWidth, .height = bottomHeight }, iterations);
+}
+
+void CpuFractalRenderer::colorize(const ColoringParams& coloring, int width, int height, std::vector<uint8_t>& rgba)
+{
+	rgba.resize(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+	if (m_paletteLut.empty() || coloring.palette != m_lutPalette)
+	{
+		m_paletteLut = PaletteLut::bake(coloring.palette);
+		m_lutPalette = coloring.palette;
+	}
+
+	// Same mirrored-repeat mapping from iteration count to palette position as ColorShader.glsl.
+	const int bands = (height + COLORIZE_ROWS_PER_TASK - 1) / COLORIZE_ROWS_PER_TASK;
+	m_scheduler.parallelFor(bands, [&](int band) {
+		const int firstRow = band * COLORIZE_ROWS_PER_TASK;
+		const int lastRow = std::min(height, firstRow + COLORIZE_ROWS_PER_TASK);
+		const size_t rowStart = static_cast<size_t>(firstRow) * static_cast<size_t>(width);
+		const size_t rowEnd = static_cast<size_t>(lastRow) * static_cast<size_t>(width);
+		for (size_t i = rowStart; i < rowEnd; ++i)
+		{
+			const float iter = m_iterations[i];
+			glm::vec3 color(0.0F);
+			if (iter > 0.0F)
+			{
+				const double v = static_cast<double>(iter) * coloring.paletteFrequency;
+				const double band = std::floor(v);
+				const double fraction = v - band;
+				const double t = (band - 2.0 * std::floor(band * 0.5) == 0.0) ? fraction : 1.0 - fraction;
+				color = PaletteLut::sample(m_paletteLut, static_cast<float>(t));
+			}
+
+			uint8_t* pixel = rgba.data() + (i * 4);
+			pixel[0] = toUnorm8(color.x);
+			pixel[1] = toUnorm8(color.y);
+			pixel[2] = toUnorm8(color.z);
+			pixel[3] = 255;
+		}
+	});
+}
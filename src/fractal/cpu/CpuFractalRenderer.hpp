@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "CpuKernels.hpp"
+#include "core/TaskScheduler.hpp"
+#include "fractal/BlaTable.hpp"
+#include "fractal/FractalState.hpp"
+#include "fractal/ReferenceOrbit.hpp"
+
+struct CpuRenderStats
+{
+		double milliseconds = 0.0;
+		double megapixelsPerSecond = 0.0;
+		double filledPixelRatio = 0.0; // Share of pixels rectangle subdivision filled without iterating.
+		std::vector<WorkerStats> workers;
+};
+
+// Result of rendering the same view with and without bilinear approximation.
+struct IterationSkippingReport
+{
+		bool valid = false;
+		int width = 0;
+		int height = 0;
+		double mismatchedPixelRatio = 0.0; // Pixels whose iteration value moved by more than the tolerance.
+		double maxDifference = 0.0;
+		double skippedIterationRatio = 0.0; // Share of all iterations covered by table lookups.
+};
+
+// Multithreaded SIMD implementation of MainShader.glsl. The kernel for the widest instruction set the CPU
+// supports is picked once at construction; the image is split into tiles that run on the shared
+// TaskScheduler, and output is RGBA8 in the same row order the compute shader writes.
+class CpuFractalRenderer
+{
+	public:
+		explicit CpuFractalRenderer(TaskScheduler& scheduler);
+
+		// With a reference orbit of the view center the supported fractals render through perturbation.
+		void render(const FractalState& state, int width, int height, std::vector<uint8_t>& rgba,
+					const ReferenceOrbit* reference = nullptr, const BlaTable* bla = nullptr);
+
+		// Maps the iterations of the last render() through a new palette without iterating again. Returns false when
+		// that render was not width x height.
+		bool recolor(const ColoringParams& coloring, int width, int height, std::vector<uint8_t>& rgba);
+
+		// Renders a width x height sample of the view twice, once iterating every step, and compares the two.
+		IterationSkippingReport compareIterationSkipping(const FractalState& state, int width, int height,
+														 const ReferenceOrbit& reference, const BlaTable& bla);
+
+		// Rectangle subdivision relies on the set being connected, which only holds for these fractals.
+		static bool supportsSubdivision(FractalType type)
+		{
+			return type == FractalType::Mandelbrot || type == FractalType::Julia;
+		}
+
+		[[nodiscard]] std::string_view getIsaName() const { return m_isaName; }
+		[[nodiscard]] const CpuRenderStats& getLastStats() const { return m_lastStats; }
+
+	private:
+		static CpuKernels::KernelParams makeParams(const FractalState& state, int width, int height,
+												   const ReferenceOrbit* reference, const BlaTable* bla);
+		// Returns how many pixels subdivision filled without iterating (always 0 when `subdivide` is off).
+		size_t computeIterations(const CpuKernels::KernelParams& params, std::vector<float>& iterations,
+								 bool subdivide = false, std::vector<CpuKernels::IterationCounts>* tileCounts = nullptr);
+		size_t renderTileSubdivided(const CpuKernels::KernelParams& params, const CpuKernels::TileRect& tile,
+									float* iterations) const;
+		size_t subdivide(const CpuKernels::KernelParams& params, const CpuKernels::TileRect& rect,
+						 float* iterations) const;
+		void colorize(const ColoringParams& coloring, int width, int height, std::vector<uint8_t>& rgba);
+
+		TaskScheduler& m_scheduler;
+		CpuKernels::TileKernel m_kernel = nullptr;
+		std::string_view m_isaName;
+
+		std::vector<float> m_iterations;
+		std::vector<glm::vec3> m_paletteLut;
+		std::vector<ColorStop> m_lutPalette; // Stops m_paletteLut was baked from.
+		CpuRenderStats m_lastStats;
+};
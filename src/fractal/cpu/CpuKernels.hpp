@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/vec2.hpp>
+
+#include "fractal/FractalTypes.hpp"
+
+struct BlaStep;
+
+namespace CpuKernels
+{
+	struct IterationCounts
+	{
+			uint64_t stepped = 0;
+			uint64_t skipped = 0;
+	};
+
+	// Everything a kernel needs to map pixels to the complex plane, mirroring the uniforms of MainShader.glsl.
+	struct KernelParams
+	{
+			FractalType type = FractalType::Mandelbrot;
+			int width = 0;
+			int height = 0;
+			double offsetX = 0.0;
+			double offsetY = 0.0;
+			double zoom = 1.0;
+			int maxIterations = 0;
+			bool useSmoothing = true;
+			double juliaX = 0.0;
+			double juliaY = 0.0;
+
+			// When set, pixels iterate as deltas against this orbit of the view center (see ReferenceOrbit)
+			// instead of from their absolute coordinates. referenceLength is the index of the last point.
+			const glm::dvec2* referenceOrbit = nullptr;
+			int referenceLength = 0;
+
+			// Mandelbrot only: bilinear approximations over the same orbit (see BlaTable); null iterates every step.
+			const BlaStep* blaSteps = nullptr;
+			int blaLevelCount = 0;
+
+			// Optional tally of stepped and skipped iterations on the perturbation path. Not synchronized, so
+			// every concurrently running tile needs its own.
+			IterationCounts* counts = nullptr;
+	};
+
+	struct TileRect
+	{
+			int x = 0;
+			int y = 0;
+			int width = 0;
+			int height = 0;
+	};
+
+	// Writes the iteration value of every pixel in `tile` into `iterations`, a row-major buffer of
+	// params.width * params.height floats. The values match what fractalFunction returns on the GPU.
+	using TileKernel = void (*)(const KernelParams& params, const TileRect& tile, float* iterations);
+
+	void renderTileScalar(const KernelParams& params, const TileRect& tile, float* iterations);
+#if defined(FRACTAVISTA_HAS_X86_SIMD)
+	void renderTileAVX2(const KernelParams& params, const TileRect& tile, float* iterations);
+	void renderTileAVX512(const KernelParams& params, const TileRect& tile, float* iterations);
+#endif
+}
@@ -0,0 +1,9 @@
+// Built with AVX2 + FMA code generation; only reached after CpuFractalRenderer has confirmed support at runtime.
+#define CPU_KERNEL_ISA avx2
+#define CPU_KERNEL_USE_AVX2
+#include "CpuKernelsImpl.hpp"
+
+void CpuKernels::renderTileAVX2(const KernelParams& params, const TileRect& tile, float* iterations)
+{
+	avx2::renderTile(params, tile, iterations);
+}
@@ -0,0 +1,9 @@
+// Built with AVX-512F code generation; only reached after CpuFractalRenderer has confirmed support at runtime.
+#define CPU_KERNEL_ISA avx512
+#define CPU_KERNEL_USE_AVX512
+#include "CpuKernelsImpl.hpp"
+
+void CpuKernels::renderTileAVX512(const KernelParams& params, const TileRect& tile, float* iterations)
+{
+	avx512::renderTile(params, tile, iterations);
+}
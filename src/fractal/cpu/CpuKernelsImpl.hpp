@@ -0,0 +1,386 @@
+#pragma once
+
+// Vectorized ports of the escape-time kernels in assets/shaders. This header is compiled once per instruction
+// set (see CpuKernelsScalar.cpp, CpuKernelsAVX2.cpp and CpuKernelsAVX512.cpp); each lane of a Vec is one pixel.
+// Everything here is static and calls no inline function from std or glm: the linker keeps one copy of such a
+// function for the whole program, and an AVX-512 copy picked for a scalar caller would crash older CPUs.
+
+#include <cmath>
+
+#include "CpuKernels.hpp"
+#include "SimdTypes.hpp"
+#include "fractal/BlaTable.hpp"
+
+namespace CpuKernels::CPU_KERNEL_ISA
+{
+	constexpr double ESCAPE_RADIUS_SQ = 4.0 * 4.0;
+	constexpr double NEWTON_DEGENERATE_SQ = 0.0001;
+	constexpr double NEWTON_CONVERGENCE_SQ = 0.000001;
+	// Distance, in pixels, within which a returning orbit counts as cycling. Well below a pixel so that slowly
+	// escaping orbits near the boundary are not mistaken for interior ones.
+	constexpr double CYCLE_TOLERANCE_PIXELS = 1.0 / 1024.0;
+
+	struct LaneResults
+	{
+			alignas(64) double iterations[LANES];
+			alignas(64) double magnitudeSq[LANES];
+	};
+
+	// Runs z = step(z, c) on every active lane until it leaves the escape radius, counting the completed
+	// iterations the same way the shaders do (the escaping step is not counted).
+	//
+	// With a non-zero cycleToleranceSq, lanes whose orbit returns to within that squared distance of a saved point
+	// are caught in an attracting cycle and finish as interior right away. Points are saved at power-of-two
+	// iterations (Brent), so any period is found within about twice its length once the orbit has settled.
+	template <typename StepFn>
+	static inline void escapeTime(Vec zx, Vec zy, Vec cx, Vec cy, Mask active, int maxIterations, StepFn step,
+						   LaneResults& out, double cycleToleranceSq = 0.0)
+	{
+		const Vec one = broadcast(1.0);
+		const Vec zero = broadcast(0.0);
+		const Vec bailout = broadcast(ESCAPE_RADIUS_SQ);
+		const Vec toleranceSq = broadcast(cycleToleranceSq);
+		const Vec iterationCap = broadcast(static_cast<double>(maxIterations));
+
+		Vec n = zero;
+		Vec savedX = zx;
+		Vec savedY = zy;
+		int sinceSaved = 0;
+		int saveInterval = 1;
+		for (int i = 0; i < maxIterations && any(active); ++i)
+		{
+			Vec nextX{};
+			Vec nextY{};
+			step(zx, zy, cx, cy, nextX, nextY);
+			zx = select(active, nextX, zx);
+			zy = select(active, nextY, zy);
+
+			active = andNot(active, (zx * zx + zy * zy) > bailout);
+			n = n + select(active, one, zero);
+
+			if (cycleToleranceSq > 0.0)
+			{
+				const Vec dx = zx - savedX;
+				const Vec dy = zy - savedY;
+				const Mask cycled = active & ((dx * dx + dy * dy) < toleranceSq);
+				n = select(cycled, iterationCap, n);
+				active = andNot(active, cycled);
+
+				if (++sinceSaved == saveInterval)
+				{
+					savedX = zx;
+					savedY = zy;
+					sinceSaved = 0;
+					saveInterval *= 2;
+				}
+			}
+		}
+
+		store(out.iterations, n);
+		store(out.magnitudeSq, zx * zx + zy * zy);
+	}
+
+	static inline void mandelbrotStep(Vec zx, Vec zy, Vec cx, Vec cy, Vec& outX, Vec& outY)
+	{
+		outX = zx * zx - zy * zy + cx;
+		outY = broadcast(2.0) * zx * zy + cy;
+	}
+
+	static inline void burningShipStep(Vec zx, Vec zy, Vec cx, Vec cy, Vec& outX, Vec& outY)
+	{
+		const Vec ax = abs(zx);
+		const Vec ay = abs(zy);
+		outX = ax * ax - ay * ay + cx;
+		outY = broadcast(2.0) * ax * ay + cy;
+	}
+
+	static inline void tricornStep(Vec zx, Vec zy, Vec cx, Vec cy, Vec& outX, Vec& outY)
+	{
+		outX = zx * zx - zy * zy + cx;
+		outY = broadcast(-2.0) * zx * zy + cy;
+	}
+
+	static inline void cubicStep(Vec zx, Vec zy, Vec cx, Vec cy, Vec& outX, Vec& outY)
+	{
+		const Vec zx2 = zx * zx;
+		const Vec zy2 = zy * zy;
+		const Vec three = broadcast(3.0);
+		outX = zx * zx2 - three * zx * zy2 + cx;
+		outY = three * zx2 * zy - zy * zy2 + cy;
+	}
+
+	static inline void newton(Vec zx, Vec zy, int maxIterations, LaneResults& out)
+	{
+		const Vec one = broadcast(1.0);
+		const Vec zero = broadcast(0.0);
+		const Vec three = broadcast(3.0);
+		const Vec degenerateSq = broadcast(NEWTON_DEGENERATE_SQ);
+		const Vec convergenceSq = broadcast(NEWTON_CONVERGENCE_SQ);
+		const Vec iterationCap = broadcast(static_cast<double>(maxIterations));
+
+		Vec n = zero;
+		Mask active = allLanes();
+		for (int i = 0; i < maxIterations && any(active); ++i)
+		{
+			// f(z) = z^3 - 1, f'(z) = 3z^2
+			const Vec z2x = zx * zx - zy * zy;
+			const Vec z2y = broadcast(2.0) * zx * zy;
+			const Vec fx = z2x * zx - z2y * zy - one;
+			const Vec fy = z2x * zy + z2y * zx;
+			const Vec dfx = three * z2x;
+			const Vec dfy = three * z2y;
+			const Vec den = dfx * dfx + dfy * dfy;
+
+			const Mask degenerate = active & (den < degenerateSq);
+			n = select(degenerate, iterationCap, n);
+			active = andNot(active, degenerate);
+
+			const Vec stepX = (fx * dfx + fy * dfy) / den;
+			const Vec stepY = (fy * dfx - fx * dfy) / den;
+			zx = select(active, zx - stepX, zx);
+			zy = select(active, zy - stepY, zy);
+
+			n = n + select(active, one, zero);
+			active = andNot(active, (stepX * stepX + stepY * stepY) < convergenceSq);
+		}
+
+		store(out.iterations, n);
+		store(out.magnitudeSq, zx * zx + zy * zy);
+	}
+
+	// |c + d| - |c| without the cancellation of evaluating both absolute values.
+	static inline double diffAbs(double c, double d)
+	{
+		if (c >= 0.0)
+			return (c + d >= 0.0) ? d : -(2.0 * c + d);
+		return (c + d > 0.0) ? 2.0 * c + d : -d;
+	}
+
+	// Longest table entry that starts at reference index `ref`, is valid for |dz|^2 = dzNormSq and does not run past
+	// `remaining` iterations. Radii only shrink as entries merge, so the search stops at the first level that fails.
+	static inline const BlaStep* findBla(const KernelParams& params, int ref, double dzNormSq, int remaining,
+										 int& length)
+	{
+		length = 0;
+		if (ref < 1)
+			return nullptr;
+
+		const BlaStep* best = nullptr;
+		int levelOffset = 0;
+		int count = params.referenceLength - 1;
+		for (int level = 0; level < params.blaLevelCount; ++level)
+		{
+			const int span = 1 << level;
+			const int j = (ref - 1) >> level;
+			if (((ref - 1) & (span - 1)) != 0 || span > remaining || j >= count)
+				break;
+
+			const BlaStep& step = params.blaSteps[levelOffset + j];
+			if (dzNormSq >= step.radius * step.radius)
+				break;
+
+			best = &step;
+			length = span;
+			levelOffset += count;
+			count /= 2;
+		}
+		return best;
+	}
+
+	// Perturbation counterpart of escapeTime for one pixel: iterates dz against the reference orbit Z so only
+	// the small pixel offset dc has to fit in a double. When |Z + dz| drops below |dz| (or the reference runs
+	// out) the full value becomes the new delta against Z_0 = 0, which keeps the deltas from losing precision.
+	static inline float perturbedPixel(const KernelParams& params, double dcx, double dcy, bool smooth)
+	{
+		const glm::dvec2* orbit = params.referenceOrbit;
+		const bool useBla = params.blaSteps != nullptr && params.type == FractalType::Mandelbrot;
+		double dzx = 0.0;
+		double dzy = 0.0;
+		double magnitudeSq = 0.0;
+		int ref = 0;
+		int iteration = 0;
+		bool escaped = false;
+		uint64_t skipped = 0;
+
+		while (iteration < params.maxIterations)
+		{
+			int length = 0;
+			const int remaining = params.maxIterations - iteration;
+			const BlaStep* bla = useBla ? findBla(params, ref, dzx * dzx + dzy * dzy, remaining, length) : nullptr;
+			if (bla != nullptr)
+			{
+				const double nextX = (bla->a.x * dzx - bla->a.y * dzy) + (bla->b.x * dcx - bla->b.y * dcy);
+				const double nextY = (bla->a.x * dzy + bla->a.y * dzx) + (bla->b.x * dcy + bla->b.y * dcx);
+				dzx = nextX;
+				dzy = nextY;
+				ref += length;
+				iteration += length;
+				skipped += static_cast<uint64_t>(length);
+			}
+			else
+			{
+				const double refX = orbit[ref].x;
+				const double refY = orbit[ref].y;
+				const double nextX = ((2.0 * refX + dzx) * dzx) - ((2.0 * refY + dzy) * dzy);
+				double nextY = 0.0;
+				switch (params.type)
+				{
+					case FractalType::Tricorn:
+						nextY = -2.0 * (refX * dzy + refY * dzx + dzx * dzy);
+						break;
+					case FractalType::BurningShip:
+						nextY = 2.0 * diffAbs(refX * refY, refX * dzy + refY * dzx + dzx * dzy);
+						break;
+					default:
+						nextY = 2.0 * (refX * dzy + refY * dzx + dzx * dzy);
+						break;
+				}
+				dzx = nextX + dcx;
+				dzy = nextY + dcy;
+				++ref;
+				++iteration;
+			}
+
+			const double zx = orbit[ref].x + dzx;
+			const double zy = orbit[ref].y + dzy;
+			magnitudeSq = zx * zx + zy * zy;
+			if (magnitudeSq > ESCAPE_RADIUS_SQ)
+			{
+				escaped = true;
+				break;
+			}
+			if (magnitudeSq < dzx * dzx + dzy * dzy || ref == params.referenceLength)
+			{
+				dzx = zx;
+				dzy = zy;
+				ref = 0;
+			}
+		}
+
+		if (params.counts != nullptr)
+		{
+			params.counts->skipped += skipped;
+			params.counts->stepped += static_cast<uint64_t>(iteration) - skipped;
+		}
+
+		// Like the shaders, the escaping step itself is not counted.
+		if (!escaped)
+			return 0.0F;
+		const int n = iteration - 1;
+		if (!smooth)
+			return static_cast<float>(n);
+		return static_cast<float>(static_cast<double>(n) - std::log2(std::log2(magnitudeSq)) + 4.0);
+	}
+
+	static inline float finishLane(const LaneResults& lanes, int lane, int maxIterations, bool smooth)
+	{
+		const double n = lanes.iterations[lane];
+		if (n >= static_cast<double>(maxIterations))
+			return 0.0F;
+		if (!smooth)
+			return static_cast<float>(n);
+		return static_cast<float>(n - std::log2(std::log2(lanes.magnitudeSq[lane])) + 4.0);
+	}
+
+	static inline void renderTile(const KernelParams& params, const TileRect& tile, float* iterations)
+	{
+		const double width = static_cast<double>(params.width);
+		const double height = static_cast<double>(params.height);
+		const double aspect = width / height;
+		const double invZoom = 1.0 / params.zoom;
+
+		// Smoothing is optional only where the GPU kernel honours the checkbox; the remaining escape-time
+		// kernels always smooth and Newton never does.
+		bool smooth = params.useSmoothing;
+		if (params.type == FractalType::Julia || params.type == FractalType::Tricorn
+			|| params.type == FractalType::CubicMandelbrot)
+			smooth = true;
+		else if (params.type == FractalType::Newton)
+			smooth = false;
+
+		const double cycleTolerance = CYCLE_TOLERANCE_PIXELS * invZoom / height;
+		const double cycleToleranceSq = cycleTolerance * cycleTolerance;
+
+		const Vec lanes = laneIndices();
+		LaneResults results{};
+
+		for (int y = tile.y; y < tile.y + tile.height; ++y)
+		{
+			const double uvY = 0.5 - (static_cast<double>(y) / height);
+			const Vec imag = broadcast(params.offsetY + uvY * invZoom);
+			float* row = iterations + (static_cast<size_t>(y) * static_cast<size_t>(params.width));
+
+			if (params.referenceOrbit != nullptr && params.referenceLength > 0)
+			{
+				// Rebasing gives every pixel its own position in the reference, so this path stays scalar.
+				const double dcy = uvY * invZoom;
+				for (int x = tile.x; x < tile.x + tile.width; ++x)
+				{
+					const double uvX = (static_cast<double>(x) / width - 0.5) * aspect;
+					row[x] = perturbedPixel(params, uvX * invZoom, dcy, smooth);
+				}
+				continue;
+			}
+
+			for (int x = tile.x; x < tile.x + tile.width; x += LANES)
+			{
+				const Vec px = broadcast(static_cast<double>(x)) + lanes;
+				const Vec uvX = (px / broadcast(width) - broadcast(0.5)) * broadcast(aspect);
+				const Vec real = broadcast(params.offsetX) + uvX * broadcast(invZoom);
+
+				switch (params.type)
+				{
+					case FractalType::Mandelbrot:
+					{
+						// Main cardioid and period-2 bulb, as in Mandelbrot.glsl.
+						const Vec c2 = real * real + imag * imag;
+						const Mask inCardioid = (broadcast(256.0) * c2 * c2 - broadcast(96.0) * c2
+												 + broadcast(32.0) * real - broadcast(3.0))
+												< broadcast(0.0);
+						const Mask inBulb
+							= (broadcast(16.0) * (c2 + broadcast(2.0) * real + broadcast(1.0)) - broadcast(1.0))
+							  < broadcast(0.0);
+						const Mask interior = inCardioid | inBulb;
+
+						escapeTime(broadcast(0.0), broadcast(0.0), real, imag, andNot(allLanes(), interior),
+								   params.maxIterations, mandelbrotStep, results, cycleToleranceSq);
+						alignas(64) double capped[LANES];
+						store(capped, select(interior, broadcast(static_cast<double>(params.maxIterations)),
+											 broadcast(0.0)));
+						for (int lane = 0; lane < LANES; ++lane)
+						{
+							if (capped[lane] > results.iterations[lane])
+								results.iterations[lane] = capped[lane];
+						}
+						break;
+					}
+					case FractalType::Julia:
+						escapeTime(real, imag, broadcast(params.juliaX), broadcast(params.juliaY), allLanes(),
+								   params.maxIterations, mandelbrotStep, results, cycleToleranceSq);
+						break;
+					case FractalType::BurningShip:
+						escapeTime(broadcast(0.0), broadcast(0.0), real, imag, allLanes(), params.maxIterations,
+								   burningShipStep, results);
+						break;
+					case FractalType::Tricorn:
+						escapeTime(broadcast(0.0), broadcast(0.0), real, imag, allLanes(), params.maxIterations,
+								   tricornStep, results, cycleToleranceSq);
+						break;
+					case FractalType::CubicMandelbrot:
+						escapeTime(broadcast(0.0), broadcast(0.0), real, imag, allLanes(), params.maxIterations,
+								   cubicStep, results, cycleToleranceSq);
+						break;
+					case FractalType::Newton:
+						newton(real, imag, params.maxIterations, results);
+						break;
+				}
+
+				const int validLanes = (tile.x + tile.width - x) < LANES ? (tile.x + tile.width - x) : LANES;
+				for (int lane = 0; lane < validLanes; ++lane)
+				{
+					row[x + lane] = finishLane(results, lane, params.maxIterations, smooth);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,8 @@
+// Portable fallback used when the CPU (or the build target) offers no wider vector unit.
+#define CPU_KERNEL_ISA scalar
+#include "CpuKernelsImpl.hpp"
+
+void CpuKernels::renderTileScalar(const KernelParams& params, const TileRect& tile, float* iterations)
+{
+	scalar::renderTile(params, tile, iterations);
+}
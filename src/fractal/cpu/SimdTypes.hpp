@@ -0,0 +1,259 @@
+#pragma once
+
+// Thin wrappers over one SIMD register of doubles. The including translation unit selects the instruction set
+// with CPU_KERNEL_USE_AVX512 / CPU_KERNEL_USE_AVX2 (scalar otherwise) and names the enclosing namespace with
+// CPU_KERNEL_ISA. The functions are static as well, so the linker never merges copies compiled for different
+// instruction sets.
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(CPU_KERNEL_USE_AVX2) || defined(CPU_KERNEL_USE_AVX512)
+#include <immintrin.h>
+#endif
+
+#if !defined(CPU_KERNEL_ISA)
+#error "CPU_KERNEL_ISA must name the instruction set namespace before including SimdTypes.hpp"
+#endif
+
+namespace CpuKernels::CPU_KERNEL_ISA
+{
+#if defined(CPU_KERNEL_USE_AVX512)
+
+	constexpr int LANES = 8;
+
+	struct Vec
+	{
+			__m512d v;
+	};
+
+	struct Mask
+	{
+			__mmask8 m;
+	};
+
+	static inline Vec broadcast(double x)
+	{
+		return { _mm512_set1_pd(x) };
+	}
+	static inline Vec laneIndices()
+	{
+		return { _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0) };
+	}
+	static inline Vec operator+(Vec a, Vec b)
+	{
+		return { _mm512_add_pd(a.v, b.v) };
+	}
+	static inline Vec operator-(Vec a, Vec b)
+	{
+		return { _mm512_sub_pd(a.v, b.v) };
+	}
+	static inline Vec operator*(Vec a, Vec b)
+	{
+		return { _mm512_mul_pd(a.v, b.v) };
+	}
+	static inline Vec operator/(Vec a, Vec b)
+	{
+		return { _mm512_div_pd(a.v, b.v) };
+	}
+	static inline Vec abs(Vec a)
+	{
+		return { _mm512_abs_pd(a.v) };
+	}
+	static inline Mask operator<(Vec a, Vec b)
+	{
+		return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ) };
+	}
+	static inline Mask operator>(Vec a, Vec b)
+	{
+		return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ) };
+	}
+	static inline Mask operator&(Mask a, Mask b)
+	{
+		return { static_cast<__mmask8>(a.m & b.m) };
+	}
+	static inline Mask operator|(Mask a, Mask b)
+	{
+		return { static_cast<__mmask8>(a.m | b.m) };
+	}
+	static inline Mask andNot(Mask a, Mask b)
+	{
+		return { static_cast<__mmask8>(a.m & ~b.m) };
+	}
+	static inline Mask allLanes()
+	{
+		return { static_cast<__mmask8>(0xFF) };
+	}
+	static inline bool any(Mask a)
+	{
+		return a.m != 0;
+	}
+	static inline Vec select(Mask m, Vec a, Vec b)
+	{
+		return { _mm512_mask_blend_pd(m.m, b.v, a.v) };
+	}
+	static inline void store(double* out, Vec a)
+	{
+		_mm512_storeu_pd(out, a.v);
+	}
+
+#elif defined(CPU_KERNEL_USE_AVX2)
+
+	constexpr int LANES = 4;
+
+	struct Vec
+	{
+			__m256d v;
+	};
+
+	struct Mask
+	{
+			__m256d m;
+	};
+
+	static inline Vec broadcast(double x)
+	{
+		return { _mm256_set1_pd(x) };
+	}
+	static inline Vec laneIndices()
+	{
+		return { _mm256_set_pd(3.0, 2.0, 1.0, 0.0) };
+	}
+	static inline Vec operator+(Vec a, Vec b)
+	{
+		return { _mm256_add_pd(a.v, b.v) };
+	}
+	static inline Vec operator-(Vec a, Vec b)
+	{
+		return { _mm256_sub_pd(a.v, b.v) };
+	}
+	static inline Vec operator*(Vec a, Vec b)
+	{
+		return { _mm256_mul_pd(a.v, b.v) };
+	}
+	static inline Vec operator/(Vec a, Vec b)
+	{
+		return { _mm256_div_pd(a.v, b.v) };
+	}
+	static inline Vec abs(Vec a)
+	{
+		return { _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v) };
+	}
+	static inline Mask operator<(Vec a, Vec b)
+	{
+		return { _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ) };
+	}
+	static inline Mask operator>(Vec a, Vec b)
+	{
+		return { _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ) };
+	}
+	static inline Mask operator&(Mask a, Mask b)
+	{
+		return { _mm256_and_pd(a.m, b.m) };
+	}
+	static inline Mask operator|(Mask a, Mask b)
+	{
+		return { _mm256_or_pd(a.m, b.m) };
+	}
+	static inline Mask andNot(Mask a, Mask b)
+	{
+		return { _mm256_andnot_pd(b.m, a.m) };
+	}
+	static inline Mask allLanes()
+	{
+		return { _mm256_castsi256_pd(_mm256_set1_epi64x(-1)) };
+	}
+	static inline bool any(Mask a)
+	{
+		return _mm256_movemask_pd(a.m) != 0;
+	}
+	static inline Vec select(Mask m, Vec a, Vec b)
+	{
+		return { _mm256_blendv_pd(b.v, a.v, m.m) };
+	}
+	static inline void store(double* out, Vec a)
+	{
+		_mm256_storeu_pd(out, a.v);
+	}
+
+#else
+
+	constexpr int LANES = 1;
+
+	struct Vec
+	{
+			double v;
+	};
+
+	struct Mask
+	{
+			bool m;
+	};
+
+	static inline Vec broadcast(double x)
+	{
+		return { x };
+	}
+	static inline Vec laneIndices()
+	{
+		return { 0.0 };
+	}
+	static inline Vec operator+(Vec a, Vec b)
+	{
+		return { a.v + b.v };
+	}
+	static inline Vec operator-(Vec a, Vec b)
+	{
+		return { a.v - b.v };
+	}
+	static inline Vec operator*(Vec a, Vec b)
+	{
+		return { a.v * b.v };
+	}
+	static inline Vec operator/(Vec a, Vec b)
+	{
+		return { a.v / b.v };
+	}
+	static inline Vec abs(Vec a)
+	{
+		return { std::abs(a.v) };
+	}
+	static inline Mask operator<(Vec a, Vec b)
+	{
+		return { a.v < b.v };
+	}
+	static inline Mask operator>(Vec a, Vec b)
+	{
+		return { a.v > b.v };
+	}
+	static inline Mask operator&(Mask a, Mask b)
+	{
+		return { a.m && b.m };
+	}
+	static inline Mask operator|(Mask a, Mask b)
+	{
+		return { a.m || b.m };
+	}
+	static inline Mask andNot(Mask a, Mask b)
+	{
+		return { a.m && !b.m };
+	}
+	static inline Mask allLanes()
+	{
+		return { true };
+	}
+	static inline bool any(Mask a)
+	{
+		return a.m;
+	}
+	static inline Vec select(Mask m, Vec a, Vec b)
+	{
+		return m.m ? a : b;
+	}
+	static inline void store(double* out, Vec a)
+	{
+		*out = a.v;
+	}
+
+#endif
+}
@@ -0,0 +1,57 @@
+#include "GpuTimer.hpp"
+
+GpuTimer::GpuTimer()
+{
+	glGenQueries(static_cast<GLsizei>(QUERY_COUNT), m_queries.data());
+}
+
+GpuTimer::~GpuTimer()
+{
+	if (m_isOpen)
+		glEndQuery(GL_TIME_ELAPSED);
+	glDeleteQueries(static_cast<GLsizei>(QUERY_COUNT), m_queries.data());
+}
+
+bool GpuTimer::begin()
+{
+	if (m_isOpen || m_issued - m_collected == QUERY_COUNT)
+		return false;
+
+	glBeginQuery(GL_TIME_ELAPSED, m_queries[m_issued % QUERY_COUNT]);
+	m_isOpen = true;
+	return true;
+}
+
+void GpuTimer::end(double work)
+{
+	if (!m_isOpen)
+		return;
+
+	glEndQuery(GL_TIME_ELAPSED);
+	m_work[m_issued % QUERY_COUNT] = work;
+	++m_issued;
+	m_isOpen = false;
+}
+
+std::vector<GpuTimer::Measurement> GpuTimer::collect(bool wait)
+{
+	std::vector<Measurement> measurements;
+	while (m_collected < m_issued)
+	{
+		const GLuint query = m_queries[m_collected % QUERY_COUNT];
+		if (!wait)
+		{
+			GLint available = GL_FALSE;
+			glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available == GL_FALSE)
+				break;
+		}
+
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+		measurements.push_back({ .milliseconds = static_cast<double>(nanoseconds) / 1e6,
+								 .work = m_work[m_collected % QUERY_COUNT] });
+		++m_collected;
+	}
+	return measurements;
+}
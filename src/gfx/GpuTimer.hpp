@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <glad/gl.h>
+
+// Measures how long the GPU spends on a range of commands with GL_TIME_ELAPSED queries, without stalling: results
+// are collected frames later, once the GPU got there. GL allows only one such range open at a time.
+class GpuTimer
+{
+	public:
+		struct Measurement
+		{
+				double milliseconds = 0.0;
+				double work = 0.0; // Whatever the caller measured the range's work in, passed to end().
+		};
+
+		GpuTimer();
+		~GpuTimer();
+
+		GpuTimer(const GpuTimer&) = delete;
+		GpuTimer& operator=(const GpuTimer&) = delete;
+		GpuTimer(GpuTimer&&) = delete;
+		GpuTimer& operator=(GpuTimer&&) = delete;
+
+		// Opens a range. Returns false, and times nothing, while every query is still waiting for its result.
+		bool begin();
+		// Closes the range opened by begin().
+		void end(double work);
+		// Returns the ranges whose results arrived since the last call, oldest first. Only blocks with `wait`, which
+		// waits for every closed range.
+		std::vector<Measurement> collect(bool wait = false);
+
+	private:
+		static constexpr size_t QUERY_COUNT = 4;
+
+		std::array<GLuint, QUERY_COUNT> m_queries{};
+		std::array<double, QUERY_COUNT> m_work{};
+		size_t m_issued = 0;
+		size_t m_collected = 0;
+		bool m_isOpen = false;
+};
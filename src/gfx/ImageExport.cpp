@@ -0,0 +1,116 @@
+#include "ImageExport.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+
+#include "util/Logger.hpp"
+
+namespace
+{
+	constexpr int FLIP_ROWS_PER_TASK = 64;
+	constexpr int JPG_QUALITY = 95;
+}
+
+namespace ImageExport
+{
+	std::string_view getExtension(ScreenshotFormat format)
+	{
+		switch (format)
+		{
+			case ScreenshotFormat::JPG:
+				return ".jpg";
+			case ScreenshotFormat::BMP:
+				return ".bmp";
+			case ScreenshotFormat::PNG:
+				break;
+		}
+		return ".png";
+	}
+
+	void flipRows(TaskScheduler& scheduler, std::vector<uint8_t>& pixels, int width, int height)
+	{
+		const size_t rowPitch = static_cast<size_t>(width) * 4;
+		const int rowPairs = height / 2;
+		scheduler.parallelFor((rowPairs + FLIP_ROWS_PER_TASK - 1) / FLIP_ROWS_PER_TASK, [&](int chunk) {
+			std::span<uint8_t> bufferSpan(pixels.data(), pixels.size());
+			const int lastRow = std::min(rowPairs, (chunk + 1) * FLIP_ROWS_PER_TASK);
+			for (int y = chunk * FLIP_ROWS_PER_TASK; y < lastRow; ++y)
+			{
+				const size_t offset1 = static_cast<size_t>(y) * rowPitch;
+				const size_t offset2 = static_cast<size_t>(height - 1 - y) * rowPitch;
+
+				auto row1 = bufferSpan.subspan(offset1, rowPitch);
+				auto row2 = bufferSpan.subspan(offset2, rowPitch);
+
+				std::swap_ranges(row1.begin(), row1.end(), row2.begin());
+			}
+		});
+	}
+
+	bool save(const ScreenshotRequest& request, int width, int height, std::vector<uint8_t>& pixels)
+	{
+		SDL_Surface* surface = SDL_CreateSurfaceFrom(width, height, SDL_PIXELFORMAT_ABGR8888, pixels.data(), width * 4);
+		if (!surface)
+		{
+			FRACTAL_ERROR("Failed to create SDL_Surface for screenshot: {}", SDL_GetError());
+			return false;
+		}
+
+		bool success = false;
+		std::string pathStr = request.filepath.string();
+
+		switch (request.format)
+		{
+			case ScreenshotFormat::PNG:
+				success = IMG_SavePNG(surface, pathStr.c_str());
+				break;
+			case ScreenshotFormat::JPG:
+			{
+				SDL_Surface* rgbSurface = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGB24);
+				if (rgbSurface)
+				{
+					success = IMG_SaveJPG(rgbSurface, pathStr.c_str(), JPG_QUALITY);
+					SDL_DestroySurface(rgbSurface);
+				}
+				else
+				{
+					FRACTAL_ERROR("Failed to convert surface for JPG saving: {}", SDL_GetError());
+				}
+			}
+			break;
+			case ScreenshotFormat::BMP:
+				success = SDL_SaveBMP(surface, pathStr.c_str());
+				break;
+		}
+
+		if (!success)
+		{
+			FRACTAL_ERROR("Failed to save screenshot: {}", SDL_GetError());
+		}
+		else
+		{
+			FRACTAL_INFO("Screenshot saved to {}", request.filepath.string());
+		}
+
+		SDL_DestroySurface(surface);
+		return success;
+	}
+
+	void saveAsync(TaskScheduler& scheduler, const ScreenshotRequest& request, int width, int height,
+				   std::vector<uint8_t> pixels, RowOrder order)
+	{
+		auto shared = std::make_shared<std::vector<uint8_t>>(std::move(pixels));
+		scheduler.submit([&scheduler, request, width, height, order, shared]() {
+			// A worker that calls parallelFor runs the bands itself while it waits, so flipping from a task is safe.
+			if (order == RowOrder::BottomUp)
+				flipRows(scheduler, *shared, width, height);
+			save(request, width, height, *shared);
+		});
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "core/TaskScheduler.hpp"
+#include "ui/UIState.hpp"
+
+// Writing rendered RGBA8 images to disk. Both backends produce rows bottom to top, the way OpenGL reads them back.
+namespace ImageExport
+{
+	// File extension of the format, with the leading dot.
+	std::string_view getExtension(ScreenshotFormat format);
+
+	// Reverses the row order in place, in parallel bands.
+	void flipRows(TaskScheduler& scheduler, std::vector<uint8_t>& pixels, int width, int height);
+
+	// Encodes top-to-bottom pixels in the requested format. Failures are logged and reported as false.
+	bool save(const ScreenshotRequest& request, int width, int height, std::vector<uint8_t>& pixels);
+
+	enum class RowOrder
+	{
+		TopDown,
+		BottomUp
+	};
+
+	// Encodes on a worker, so the caller can go on rendering; bottom-up pixels are flipped there as well. Encoding can
+	// take seconds for large exports.
+	void saveAsync(TaskScheduler& scheduler, const ScreenshotRequest& request, int width, int height,
+				   std::vector<uint8_t> pixels, RowOrder order);
+}
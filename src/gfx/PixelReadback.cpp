@@ -0,0 +1,129 @@
+#include "PixelReadback.hpp"
+
+#include <cstring>
+#include <utility>
+
+#include "util/Logger.hpp"
+
+namespace
+{
+	// finish() waits in slices this long, so a lost context shows up as an error instead of a hang.
+	constexpr GLuint64 WAIT_SLICE_NS = 100'000'000;
+	constexpr int MAX_WAIT_SLICES = 100;
+}
+
+PixelReadback::~PixelReadback()
+{
+	release();
+}
+
+PixelReadback::PixelReadback(PixelReadback&& other) noexcept
+	: m_buffer(std::exchange(other.m_buffer, 0)), m_capacity(std::exchange(other.m_capacity, 0)),
+	  m_fence(std::exchange(other.m_fence, nullptr)), m_width(other.m_width), m_height(other.m_height)
+{
+}
+
+PixelReadback& PixelReadback::operator=(PixelReadback&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		m_buffer = std::exchange(other.m_buffer, 0);
+		m_capacity = std::exchange(other.m_capacity, 0);
+		m_fence = std::exchange(other.m_fence, nullptr);
+		m_width = other.m_width;
+		m_height = other.m_height;
+	}
+	return *this;
+}
+
+void PixelReadback::release()
+{
+	if (m_fence != nullptr)
+	{
+		glDeleteSync(m_fence);
+		m_fence = nullptr;
+	}
+	if (m_buffer != 0)
+	{
+		glDeleteBuffers(1, &m_buffer);
+		m_buffer = 0;
+	}
+}
+
+void PixelReadback::start(const Texture& texture)
+{
+	if (m_fence != nullptr)
+		glDeleteSync(m_fence); // The copy still in flight is superseded; the buffer is simply overwritten.
+
+	m_width = texture.getWidth();
+	m_height = texture.getHeight();
+	const size_t size = static_cast<size_t>(m_width) * static_cast<size_t>(m_height) * 4;
+
+	if (m_buffer == 0)
+		glGenBuffers(1, &m_buffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer);
+	if (size != m_capacity)
+	{
+		glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_READ);
+		m_capacity = size;
+	}
+
+	glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	texture.bind();
+	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glFlush(); // Submit now, so the fence can signal without anyone waiting on it.
+}
+
+bool PixelReadback::isReady() const
+{
+	if (m_fence == nullptr)
+		return false;
+
+	const GLenum status = glClientWaitSync(m_fence, 0, 0);
+	return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+std::vector<uint8_t> PixelReadback::finish()
+{
+	std::vector<uint8_t> pixels;
+	if (m_fence == nullptr)
+		return pixels;
+
+	GLenum status = GL_TIMEOUT_EXPIRED;
+	for (int slice = 0; slice < MAX_WAIT_SLICES && status == GL_TIMEOUT_EXPIRED; ++slice)
+		status = glClientWaitSync(m_fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_SLICE_NS);
+	glDeleteSync(m_fence);
+	m_fence = nullptr;
+
+	if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+	{
+		FRACTAL_ERROR("Pixel readback of a {}x{} image did not complete.", m_width, m_height);
+		return pixels;
+	}
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer);
+	const auto* mapped = static_cast<const uint8_t*>(
+		glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(m_capacity), GL_MAP_READ_BIT));
+	if (mapped != nullptr)
+	{
+		const size_t rowPitch = static_cast<size_t>(m_width) * 4;
+		pixels.resize(m_capacity);
+		for (int y = 0; y < m_height; ++y)
+		{
+			std::memcpy(pixels.data() + (static_cast<size_t>(y) * rowPitch),
+						mapped + (static_cast<size_t>(m_height - 1 - y) * rowPitch), rowPitch);
+		}
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	else
+	{
+		FRACTAL_ERROR("Failed to map the pixel readback buffer.");
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	return pixels;
+}
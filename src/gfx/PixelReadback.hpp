@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glad/gl.h>
+
+#include "Texture.hpp"
+
+// Reads an RGBA8 texture back without stalling: start() queues a copy into a pixel pack buffer behind the commands
+// that render the texture, and a fence tells when the GPU got there. The pixels are only touched by the CPU once the
+// copy has landed.
+class PixelReadback
+{
+	public:
+		PixelReadback() = default;
+		~PixelReadback();
+
+		PixelReadback(const PixelReadback&) = delete;
+		PixelReadback& operator=(const PixelReadback&) = delete;
+		PixelReadback(PixelReadback&& other) noexcept;
+		PixelReadback& operator=(PixelReadback&& other) noexcept;
+
+		// Queues the copy. Anything written to the texture by compute shaders before this call is included.
+		void start(const Texture& texture);
+		[[nodiscard]] bool isPending() const { return m_fence != nullptr; }
+		// True once a started copy has finished; never blocks.
+		[[nodiscard]] bool isReady() const;
+		// Waits for the copy if it is still running and returns its rows top to bottom, flipped from GL's bottom-up
+		// order while copying out of the buffer.
+		std::vector<uint8_t> finish();
+
+	private:
+		void release();
+
+		GLuint m_buffer = 0;
+		size_t m_capacity = 0;
+		GLsync m_fence = nullptr;
+		int m_width = 0;
+		int m_height = 0;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+
+#include <png.h>
+
+// Encodes a PNG a few rows at a time, so an image can be written while it is still being rendered and never has to
+// exist in memory as a whole. Rows are RGBA8, top to bottom. libpng reports errors by longjmp; every call catches
+// them, logs the reason and leaves the writer failed, after which it ignores further rows.
+class PngStreamWriter
+{
+	public:
+		// Writes the header right away. Throws std::runtime_error when the file cannot be created.
+		PngStreamWriter(const std::filesystem::path& path, int width, int height);
+		// A writer closed before finish() leaves a truncated file behind.
+		~PngStreamWriter();
+
+		PngStreamWriter(const PngStreamWriter&) = delete;
+		PngStreamWriter& operator=(const PngStreamWriter&) = delete;
+		PngStreamWriter(PngStreamWriter&&) = delete;
+		PngStreamWriter& operator=(PngStreamWriter&&) = delete;
+
+		// Appends `count` consecutive rows of width * 4 bytes each.
+		bool writeRows(const uint8_t* rows, int count);
+		// Ends the image once all rows are in and closes the file.
+		bool finish();
+
+		[[nodiscard]] int getRowsWritten() const { return m_rowsWritten; }
+
+	private:
+		std::FILE* m_file = nullptr;
+		png_structp m_png = nullptr;
+		png_infop m_info = nullptr;
+		int m_width = 0;
+		int m_height = 0;
+		int m_rowsWritten = 0;
+		bool m_failed = false;
+};
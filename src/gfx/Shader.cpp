@@ -1,25 +1,55 @@
 #include "Shader.hpp"
 
-#include <set>
 #include <stdexcept>
 #include <utility>
 
+#include <SDL3/SDL_video.h>
 #include <glm/gtc/type_ptr.hpp>
 
-#include "util/FileUtils.hpp"
 #include "util/Logger.hpp"
 
+namespace
+{
+	// KHR_parallel_shader_compile is newer than the headers glad generated for us.
+	constexpr GLenum GL_MAX_SHADER_COMPILER_THREADS_KHR_VALUE = 0x91B0;
+	constexpr GLenum GL_COMPLETION_STATUS_KHR_VALUE = 0x91B1;
+	constexpr GLuint DRIVER_CHOSEN_THREAD_COUNT = 0xFFFFFFFF;
+
+	using MaxShaderCompilerThreadsFn = void (*)(GLuint count);
+
+	bool s_parallelCompile = false;
+
+	bool hasExtension(std::string_view name)
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (GLint i = 0; i < count; ++i)
+		{
+			const auto* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+			if (extension != nullptr && name == extension)
+				return true;
+		}
+		return false;
+	}
+}
+
 Shader::Shader() = default;
 
 Shader::~Shader()
 {
+	if (m_pendingShader != 0)
+	{
+		glDeleteShader(m_pendingShader);
+	}
 	if (m_programID != 0)
 	{
 		glDeleteProgram(m_programID);
 	}
 }
 
-Shader::Shader(Shader&& other) noexcept : m_programID(std::exchange(other.m_programID, 0))
+Shader::Shader(Shader&& other) noexcept
+	: m_programID(std::exchange(other.m_programID, 0)), m_pendingShader(std::exchange(other.m_pendingShader, 0)),
+	  m_sourceFiles(std::move(other.m_sourceFiles))
 {
 }
 
@@ -27,53 +57,120 @@ Shader& Shader::operator=(Shader&& other) noexcept
 {
 	if (this != &other)
 	{
+		if (m_pendingShader != 0)
+		{
+			glDeleteShader(m_pendingShader);
+		}
 		if (m_programID != 0)
 		{
 			glDeleteProgram(m_programID);
 		}
 		m_programID = std::exchange(other.m_programID, 0);
+		m_pendingShader = std::exchange(other.m_pendingShader, 0);
+		m_sourceFiles = std::move(other.m_sourceFiles);
 	}
 	return *this;
 }
 
+bool Shader::enableParallelCompile()
+{
+	const char* function = nullptr;
+	if (hasExtension("GL_KHR_parallel_shader_compile"))
+		function = "glMaxShaderCompilerThreadsKHR";
+	else if (hasExtension("GL_ARB_parallel_shader_compile"))
+		function = "glMaxShaderCompilerThreadsARB";
+
+	if (function == nullptr)
+		return false;
+
+	auto maxThreads = reinterpret_cast<MaxShaderCompilerThreadsFn>(SDL_GL_GetProcAddress(function));
+	if (maxThreads == nullptr)
+		return false;
+
+	maxThreads(DRIVER_CHOSEN_THREAD_COUNT);
+	s_parallelCompile = true;
+	return true;
+}
+
 void Shader::compileFromPath(const std::filesystem::path& computePath, const std::vector<std::string>& defines)
 {
-	std::set<std::string> includedFiles;
-	auto optionalComputeCode = FileUtils::loadShaderSource(computePath);
-	if (!optionalComputeCode)
-	{
-		throw std::runtime_error(std::format("Failed to load shader source for path: {}", computePath.string()));
-	}
+	ShaderPreprocessor preprocessor;
+	beginCompile(preprocessor.process(computePath, defines));
+	finishCompile();
+}
+
+void Shader::beginCompile(const PreprocessedShader& shader)
+{
+	const char* computeCodeCStr = shader.source.c_str();
+	m_sourceFiles = shader.describeFiles();
 
-	std::string computeCode = *optionalComputeCode;
+	m_pendingShader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(m_pendingShader, 1, &computeCodeCStr, nullptr);
+	glCompileShader(m_pendingShader);
 
-	size_t versionPos = computeCode.find("#version");
-	if (versionPos == std::string::npos)
+	// Linking right away lets a parallel compile run both stages without another round trip.
+	m_programID = glCreateProgram();
+	glProgramParameteri(m_programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glAttachShader(m_programID, m_pendingShader);
+	glLinkProgram(m_programID);
+}
+
+bool Shader::isReady() const
+{
+	if (m_pendingShader == 0 || !s_parallelCompile)
+		return true;
+
+	GLint complete = GL_FALSE;
+	glGetProgramiv(m_programID, GL_COMPLETION_STATUS_KHR_VALUE, &complete);
+	return complete == GL_TRUE;
+}
+
+void Shader::finishCompile()
+{
+	if (m_pendingShader == 0)
+		return;
+
+	const GLuint computeShader = std::exchange(m_pendingShader, 0);
+	try
 	{
-		throw std::runtime_error("Shader must have a #version directive!");
+		checkCompileErrors(computeShader, "COMPUTE");
+		checkCompileErrors(m_programID, "PROGRAM");
 	}
-	size_t lineEnd = computeCode.find('\n', versionPos);
-
-	std::string defineBlock;
-	for (const auto& def : defines)
+	catch (const std::runtime_error& e)
 	{
-		defineBlock += std::format("#define {}\n", def);
+		glDeleteShader(computeShader);
+		throw std::runtime_error(std::format("{}\n{}", e.what(), m_sourceFiles));
 	}
-	computeCode.insert(lineEnd + 1, defineBlock);
+	glDetachShader(m_programID, computeShader);
+	glDeleteShader(computeShader);
+}
 
-	const char* computeCodeCStr = computeCode.c_str();
+bool Shader::loadBinary(GLenum format, const std::vector<uint8_t>& binary)
+{
+	m_programID = glCreateProgram();
+	glProgramBinary(m_programID, format, binary.data(), static_cast<GLsizei>(binary.size()));
 
-	GLuint computeShader = glCreateShader(GL_COMPUTE_SHADER);
-	glShaderSource(computeShader, 1, &computeCodeCStr, nullptr);
-	glCompileShader(computeShader);
-	checkCompileErrors(computeShader, "COMPUTE");
+	GLint success = GL_FALSE;
+	glGetProgramiv(m_programID, GL_LINK_STATUS, &success);
+	if (success != GL_TRUE)
+	{
+		glDeleteProgram(m_programID);
+		m_programID = 0;
+		return false;
+	}
+	return true;
+}
 
-	m_programID = glCreateProgram();
-	glAttachShader(m_programID, computeShader);
-	glLinkProgram(m_programID);
-	checkCompileErrors(m_programID, "PROGRAM");
+std::vector<uint8_t> Shader::getBinary(GLenum& format) const
+{
+	GLint length = 0;
+	glGetProgramiv(m_programID, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return {};
 
-	glDeleteShader(computeShader);
+	std::vector<uint8_t> binary(static_cast<size_t>(length));
+	glGetProgramBinary(m_programID, length, nullptr, &format, binary.data());
+	return binary;
 }
 
 void Shader::use() const
@@ -130,6 +227,11 @@ void Shader::setFloat(std::string_view name, float value) const
 	glUniform1f(glGetUniformLocation(m_programID, name.data()), value);
 }
 
+void Shader::setFloats(std::string_view name, std::span<const float> values) const
+{
+	glUniform1fv(glGetUniformLocation(m_programID, name.data()), static_cast<GLsizei>(values.size()), values.data());
+}
+
 void Shader::setDouble(std::string_view name, double value) const
 {
 	glUniform1d(glGetUniformLocation(m_programID, name.data()), value);
@@ -145,6 +247,11 @@ void Shader::setVec2(std::string_view name, const glm::dvec2& value) const
 	glUniform2dv(glGetUniformLocation(m_programID, name.data()), 1, glm::value_ptr(value));
 }
 
+void Shader::setVec2(std::string_view name, const glm::ivec2& value) const
+{
+	glUniform2iv(glGetUniformLocation(m_programID, name.data()), 1, glm::value_ptr(value));
+}
+
 void Shader::setVec3(std::string_view name, const glm::vec3& value) const
 {
 	glUniform3fv(glGetUniformLocation(m_programID, name.data()), 1, glm::value_ptr(value));
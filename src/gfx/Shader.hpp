@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -8,6 +10,8 @@
 #include <glad/gl.h>
 #include <glm/glm.hpp>
 
+#include "ShaderPreprocessor.hpp"
+
 class Shader
 {
 	public:
@@ -19,20 +23,41 @@ class Shader
 		Shader(Shader&& other) noexcept;
 		Shader& operator=(Shader&& other) noexcept;
 
+		// Turns on KHR_parallel_shader_compile when the driver has it; returns whether it did.
+		static bool enableParallelCompile();
 		void compileFromPath(const std::filesystem::path& computePath, const std::vector<std::string>& defines = {});
+		// Starts compiling and linking `shader`. With parallel compilation the driver works on it in the background
+		// until finishCompile().
+		void beginCompile(const PreprocessedShader& shader);
+		// False while a parallel compile is still running; checking without the extension would block, so it then
+		// always reports true.
+		[[nodiscard]] bool isReady() const;
+		// Waits for the program started by beginCompile() and throws on compile or link errors.
+		void finishCompile();
+		[[nodiscard]] bool isCompiling() const { return m_pendingShader != 0; }
+
+		// Adopts a binary from getBinary(); false when the driver rejects it, e.g. after a driver update.
+		bool loadBinary(GLenum format, const std::vector<uint8_t>& binary);
+		// Empty when the driver exposes no binary formats.
+		[[nodiscard]] std::vector<uint8_t> getBinary(GLenum& format) const;
+
 		void use() const;
 		void bindUBO(std::string_view blockName, GLuint bindingPoint);
 
 		void setBool(std::string_view name, bool value) const;
 		void setInt(std::string_view name, int value) const;
 		void setFloat(std::string_view name, float value) const;
+		void setFloats(std::string_view name, std::span<const float> values) const;
 		void setDouble(std::string_view name, double value) const;
 		void setVec2(std::string_view name, const glm::vec2& value) const;
 		void setVec2(std::string_view name, const glm::dvec2& value) const;
+		void setVec2(std::string_view name, const glm::ivec2& value) const;
 		void setVec3(std::string_view name, const glm::vec3& value) const;
 		void setVec3(std::string_view name, const glm::dvec3& value) const;
 
 	private:
 		static void checkCompileErrors(GLuint shader, std::string_view type);
 		GLuint m_programID = 0;
+		GLuint m_pendingShader = 0; // Compute shader object attached to m_programID until finishCompile().
+		std::string m_sourceFiles; // describeFiles() of the pending compile, to make its errors readable.
 };
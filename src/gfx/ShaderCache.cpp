@@ -0,0 +1,125 @@
+#include "ShaderCache.hpp"
+
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "util/Logger.hpp"
+
+namespace
+{
+	constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+	constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+	constexpr std::string_view ENTRY_EXTENSION = ".bin";
+
+	uint64_t hashBytes(std::string_view bytes, uint64_t hash = FNV_OFFSET_BASIS)
+	{
+		for (const char c : bytes)
+		{
+			hash ^= static_cast<uint8_t>(c);
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+
+	std::string glString(GLenum name)
+	{
+		const auto* value = reinterpret_cast<const char*>(glGetString(name));
+		return value != nullptr ? value : "";
+	}
+}
+
+ShaderCache::ShaderCache(std::filesystem::path directory) : m_directory(std::move(directory))
+{
+	GLint formatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	if (formatCount <= 0)
+	{
+		FRACTAL_INFO("Driver exposes no program binary formats; shader cache disabled.");
+		return;
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(m_directory, error);
+	if (error)
+	{
+		FRACTAL_WARN("Cannot create shader cache directory {}: {}", m_directory.string(), error.message());
+		return;
+	}
+
+	m_driver = std::format("{}\n{}\n{}\n", glString(GL_VENDOR), glString(GL_RENDERER), glString(GL_VERSION));
+	m_enabled = true;
+	FRACTAL_INFO("Shader cache at {}", m_directory.string());
+}
+
+std::filesystem::path ShaderCache::entryPath(const std::string& source) const
+{
+	return m_directory / std::format("{:016x}{}", hashBytes(source, hashBytes(m_driver)), ENTRY_EXTENSION);
+}
+
+bool ShaderCache::load(const std::string& source, Shader& shader) const
+{
+	if (!m_enabled)
+		return false;
+
+	const std::filesystem::path path = entryPath(source);
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	GLenum format = 0;
+	file.read(reinterpret_cast<char*>(&format), sizeof(format));
+	const std::vector<uint8_t> binary =
+		file ? std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>())
+			 : std::vector<uint8_t>();
+	if (binary.empty())
+	{
+		FRACTAL_WARN("Ignoring truncated shader cache entry {}", path.string());
+		return false;
+	}
+
+	if (!shader.loadBinary(format, binary))
+	{
+		FRACTAL_INFO("Driver rejected cached program {}; recompiling.", path.filename().string());
+		return false;
+	}
+	return true;
+}
+
+void ShaderCache::store(const std::string& source, const Shader& shader) const
+{
+	if (!m_enabled)
+		return;
+
+	GLenum format = 0;
+	const std::vector<uint8_t> binary = shader.getBinary(format);
+	if (binary.empty())
+		return;
+
+	// Written under a temporary name and renamed, so a crash mid-write never leaves a truncated entry behind.
+	const std::filesystem::path path = entryPath(source);
+	std::filesystem::path temporaryPath = path;
+	temporaryPath += ".tmp";
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+		file.write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+		if (!file)
+		{
+			FRACTAL_WARN("Failed to write shader cache entry {}", temporaryPath.string());
+			return;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error)
+	{
+		FRACTAL_WARN("Failed to store shader cache entry {}: {}", path.string(), error.message());
+		std::filesystem::remove(temporaryPath, error);
+	}
+}
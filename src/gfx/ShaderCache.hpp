@@ -0,0 +1,27 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "Shader.hpp"
+
+// Linked program binaries on disk. Entries are keyed by a hash of the preprocessed source together with the GL
+// vendor, renderer and version strings, so editing a shader or updating the driver misses instead of loading a stale
+// binary. Failures only cost a recompile and are never fatal.
+class ShaderCache
+{
+	public:
+		// Must be constructed with the GL context current.
+		explicit ShaderCache(std::filesystem::path directory);
+
+		// Returns true when `shader` was created from a cached binary of `source`.
+		bool load(const std::string& source, Shader& shader) const;
+		void store(const std::string& source, const Shader& shader) const;
+
+	private:
+		[[nodiscard]] std::filesystem::path entryPath(const std::string& source) const;
+
+		std::filesystem::path m_directory;
+		std::string m_driver;
+		bool m_enabled = false;
+};
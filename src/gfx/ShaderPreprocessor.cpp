@@ -0,0 +1,155 @@
+#include "ShaderPreprocessor.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+#include "util/Logger.hpp"
+
+namespace
+{
+	std::string_view skipBlanks(std::string_view text)
+	{
+		const size_t first = text.find_first_not_of(" \t");
+		return first == std::string_view::npos ? std::string_view{} : text.substr(first);
+	}
+
+	// Remainder of the line after "#<name>", or nullopt when the line is not that directive.
+	std::optional<std::string_view> matchDirective(std::string_view line, std::string_view name)
+	{
+		line = skipBlanks(line);
+		if (!line.starts_with('#'))
+			return std::nullopt;
+
+		line = skipBlanks(line.substr(1));
+		if (!line.starts_with(name))
+			return std::nullopt;
+
+		line.remove_prefix(name.size());
+		if (!line.empty() && line.front() != ' ' && line.front() != '\t' && line.front() != '\r')
+			return std::nullopt;
+		return line;
+	}
+
+	// The quoted path of an #include "file" line.
+	std::optional<std::string_view> parseInclude(std::string_view line)
+	{
+		const auto rest = matchDirective(line, "include");
+		if (!rest)
+			return std::nullopt;
+
+		const std::string_view quoted = skipBlanks(*rest);
+		if (!quoted.starts_with('"'))
+			return std::nullopt;
+
+		const size_t closing = quoted.find('"', 1);
+		if (closing == std::string_view::npos)
+			return std::nullopt;
+		return quoted.substr(1, closing - 1);
+	}
+}
+
+std::string PreprocessedShader::describeFiles() const
+{
+	std::string description = "Source strings:";
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		description += std::format("\n  {}: {}", i, files[i].string());
+	}
+	return description;
+}
+
+PreprocessedShader ShaderPreprocessor::process(const std::filesystem::path& rootPath,
+											   const std::vector<std::string>& defines)
+{
+	PreprocessedShader out;
+	append(rootPath.lexically_normal(), &defines, out);
+	return out;
+}
+
+const std::string& ShaderPreprocessor::readCached(const std::filesystem::path& path)
+{
+	std::error_code error;
+	const auto modified = std::filesystem::last_write_time(path, error);
+	if (error)
+	{
+		throw std::runtime_error(std::format("Failed to read shader file {}: {}", path.string(), error.message()));
+	}
+
+	CachedFile& cached = m_files[path.string()];
+	if (cached.modified != modified || cached.content.empty())
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+		{
+			throw std::runtime_error(std::format("Failed to open shader file {}", path.string()));
+		}
+
+		std::string content(static_cast<size_t>(file.tellg()), '\0');
+		file.seekg(0);
+		file.read(content.data(), static_cast<std::streamsize>(content.size()));
+
+		cached = CachedFile{ .modified = modified, .content = std::move(content) };
+		FRACTAL_TRACE("Loaded shader file: {}", path.string());
+	}
+	return cached.content;
+}
+
+void ShaderPreprocessor::append(const std::filesystem::path& path, const std::vector<std::string>* defines,
+								PreprocessedShader& out)
+{
+	const size_t fileIndex = out.files.size();
+	out.files.push_back(path);
+	// Element references survive rehashing, so nested includes cannot invalidate this one.
+	const std::string& content = readCached(path);
+
+	if (fileIndex > 0)
+		out.source += std::format("#line 1 {}\n", fileIndex);
+
+	bool definesPending = defines != nullptr;
+	int lineNumber = 0;
+	size_t lineStart = 0;
+	while (lineStart < content.size())
+	{
+		const size_t lineEnd = std::min(content.find('\n', lineStart), content.size());
+		const std::string_view line(content.data() + lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+		++lineNumber;
+
+		if (const auto include = parseInclude(line))
+		{
+			const std::filesystem::path includePath = (path.parent_path() / *include).lexically_normal();
+			if (std::ranges::find(out.files, includePath) != out.files.end())
+			{
+				out.source += '\n';
+				continue;
+			}
+
+			append(includePath, nullptr, out);
+			out.source += std::format("#line {} {}\n", lineNumber + 1, fileIndex);
+			continue;
+		}
+
+		out.source.append(line);
+		out.source += '\n';
+
+		if (definesPending && matchDirective(line, "version"))
+		{
+			for (const auto& define : *defines)
+			{
+				out.source += std::format("#define {}\n", define);
+			}
+			out.source += std::format("#line {} {}\n", lineNumber + 1, fileIndex);
+			definesPending = false;
+		}
+	}
+
+	if (definesPending)
+	{
+		throw std::runtime_error(std::format("Shader {} must have a #version directive!", path.string()));
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// GLSL ready for glShaderSource, plus the files its #line directives refer to.
+struct PreprocessedShader
+{
+		std::string source;
+		// Indexed by the source-string number of the #line directives: "2(14)" in a driver log is line 14 of files[2].
+		std::vector<std::filesystem::path> files;
+
+		// One "index: path" line per file, to append to compile errors.
+		[[nodiscard]] std::string describeFiles() const;
+};
+
+// Resolves #include "file" relative to the including file, inserts defines right after the root's #version line and
+// emits #line directives so driver errors point at the original file and line. Each file is included at most once.
+// Contents stay cached until the file's modification time changes, so building every variant reads each file once.
+class ShaderPreprocessor
+{
+	public:
+		// Throws std::runtime_error when a file cannot be read or the root has no #version directive.
+		PreprocessedShader process(const std::filesystem::path& rootPath, const std::vector<std::string>& defines = {});
+
+	private:
+		struct CachedFile
+		{
+				std::filesystem::file_time_type modified;
+				std::string content;
+		};
+
+		const std::string& readCached(const std::filesystem::path& path);
+		// `defines` is only passed for the root file.
+		void append(const std::filesystem::path& path, const std::vector<std::string>* defines, PreprocessedShader& out);
+
+		std::unordered_map<std::string, CachedFile> m_files;
+};
@@ -2,7 +2,19 @@
 
 #include <utility>
 
-Texture::Texture(int width, int height) : m_width(width), m_height(height)
+namespace
+{
+	void allocateStorage(GLenum internalFormat, int width, int height)
+	{
+		if (internalFormat == GL_R32F)
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, nullptr);
+		else
+			glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	}
+}
+
+Texture::Texture(int width, int height, GLenum internalFormat)
+	: m_width(width), m_height(height), m_internalFormat(internalFormat)
 {
 	glGenTextures(1, &m_textureID);
 	glBindTexture(GL_TEXTURE_2D, m_textureID);
@@ -12,7 +24,7 @@ Texture::Texture(int width, int height) : m_width(width), m_height(height)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	allocateStorage(m_internalFormat, width, height);
 }
 
 Texture::~Texture()
@@ -25,7 +37,7 @@ Texture::~Texture()
 
 Texture::Texture(Texture&& other) noexcept
 	: m_textureID(std::exchange(other.m_textureID, 0)), m_width(std::exchange(other.m_width, 0)),
-	  m_height(std::exchange(other.m_height, 0))
+	  m_height(std::exchange(other.m_height, 0)), m_internalFormat(other.m_internalFormat)
 {
 }
 
@@ -40,6 +52,7 @@ Texture& Texture::operator=(Texture&& other) noexcept
 		m_textureID = std::exchange(other.m_textureID, 0);
 		m_width = std::exchange(other.m_width, 0);
 		m_height = std::exchange(other.m_height, 0);
+		m_internalFormat = other.m_internalFormat;
 	}
 	return *this;
 }
@@ -50,9 +63,9 @@ void Texture::bind(GLuint unit) const
 	glBindTexture(GL_TEXTURE_2D, m_textureID);
 }
 
-void Texture::bindImage(GLuint unit) const
+void Texture::bindImage(GLuint unit, GLenum access) const
 {
-	glBindImageTexture(unit, m_textureID, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+	glBindImageTexture(unit, m_textureID, 0, GL_FALSE, 0, access, m_internalFormat);
 }
 
 void Texture::resize(int newWidth, int newHeight)
@@ -66,5 +79,12 @@ void Texture::resize(int newWidth, int newHeight)
 	m_height = newHeight;
 
 	glBindTexture(GL_TEXTURE_2D, m_textureID);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	allocateStorage(m_internalFormat, m_width, m_height);
+}
+
+void Texture::upload(const void* rgbaPixels)
+{
+	glBindTexture(GL_TEXTURE_2D, m_textureID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, rgbaPixels);
 }
@@ -5,7 +5,8 @@
 class Texture
 {
 	public:
-		Texture(int width, int height);
+		// internalFormat is GL_RGBA8 for displayable images or GL_R32F for per-pixel scalar data.
+		Texture(int width, int height, GLenum internalFormat = GL_RGBA8);
 		~Texture();
 
 		Texture(const Texture&) = delete;
@@ -14,8 +15,9 @@ class Texture
 		Texture& operator=(Texture&& other) noexcept;
 
 		void bind(GLuint unit = 0) const;
-		void bindImage(GLuint unit) const;
+		void bindImage(GLuint unit, GLenum access = GL_WRITE_ONLY) const;
 		void resize(int newWidth, int newHeight);
+		void upload(const void* rgbaPixels); // GL_RGBA8 textures only.
 
 		[[nodiscard]] GLuint getID() const { return m_textureID; }
 		[[nodiscard]] int getWidth() const { return m_width; }
@@ -25,4 +27,5 @@ class Texture
 		GLuint m_textureID = 0;
 		int m_width = 0;
 		int m_height = 0;
+		GLenum m_internalFormat = GL_RGBA8;
 };
@@ -0,0 +1,37 @@
+#include <stdexcept>
+#include <utility>
+
+#include "app/BatchRenderer.hpp"
+#include "util/Logger.hpp"
+
+int main(int argc, char** argv)
+{
+	Log::Init();
+	Log::SetLevel(spdlog::level::info);
+
+	int returnCode = 0;
+
+	try
+	{
+		auto options = BatchRenderer::parseArguments(argc, argv);
+		if (options)
+		{
+			BatchRenderer renderer(std::move(*options));
+			returnCode = renderer.run() == 0 ? 0 : 1;
+		}
+	}
+	catch (const std::invalid_argument& e)
+	{
+		FRACTAL_ERROR("{}. Run with --help for usage.", e.what());
+		returnCode = 2;
+	}
+	catch (const std::exception& e)
+	{
+		FRACTAL_CRITICAL("Batch rendering failed: {}", e.what());
+		returnCode = 1;
+	}
+
+	Log::Shutdown();
+
+	return returnCode;
+}
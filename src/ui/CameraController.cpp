@@ -23,12 +23,26 @@ void CameraController::setPanLimits(const glm::dvec2& limits)
 
 void CameraController::apply(FractalState& state, const Input& in)
 {
+	// Keep just enough precision for the current zoom; the camera math below only ever adds small double-precision
+	// steps to the arbitrary-precision center, so it stays cheap at any depth.
+	state.offset = state.offset.withPrecision(BigFixed::limbsForResolution(state.zoom * in.viewportSize.y));
 
 	if (in.dragging)
 	{
+		// Snap to the pixel grid and carry the fraction into the next drag event.
+		const double pixelsX = (in.delta.x * m_panSpeed) + m_panRemainder.x;
+		const double pixelsY = (in.delta.y * m_panSpeed) + m_panRemainder.y;
+		m_panRemainder = { pixelsX - std::trunc(pixelsX), pixelsY - std::trunc(pixelsY) };
 
-		state.offset.x -= (in.delta.x * m_panSpeed / in.viewportSize.y) / state.zoom;
-		state.offset.y -= (in.delta.y * m_panSpeed / in.viewportSize.y) / state.zoom;
+		const double panX = (std::trunc(pixelsX) / in.viewportSize.y) / state.zoom;
+		const double panY = (std::trunc(pixelsY) / in.viewportSize.y) / state.zoom;
+		// A collapsed viewport or a zoomed-out limit can make the step NaN or huge; the pan limits apply below.
+		state.offset.x = state.offset.x - BigFixed::saturated(panX, state.offset.x.getFractionLimbs());
+		state.offset.y = state.offset.y - BigFixed::saturated(panY, state.offset.y.getFractionLimbs());
+	}
+	else
+	{
+		m_panRemainder = { 0.0, 0.0 };
 	}
 
 	if (in.wheel != 0.0)
@@ -38,20 +52,24 @@ void CameraController::apply(FractalState& state, const Input& in)
 		const double ny = (in.mousePos.y / in.viewportSize.y) - 0.5;
 		const double aspect = in.viewportSize.x / in.viewportSize.y;
 
-		const double worldX_before = state.offset.x + (nx * aspect) / state.zoom;
-		const double worldY_before = state.offset.y + (ny) / state.zoom;
-
 		const double factor = (in.wheel > 0) ? m_zoomSpeed : (1.0 / m_zoomSpeed);
 		const double oldZoom = state.zoom;
 		state.zoom = std::clamp(oldZoom * factor, m_zoomLimits.x, m_zoomLimits.y);
 
 		if (state.zoom != oldZoom)
 		{
-			state.offset.x = worldX_before - (nx * aspect) / state.zoom;
-			state.offset.y = worldY_before - (ny) / state.zoom;
+			// Keep the point under the cursor fixed: offset + n / oldZoom == newOffset + n / newZoom. Only the
+			// difference is formed in double, so it is exact to well below a pixel however deep the view is.
+			state.offset = state.offset.withPrecision(BigFixed::limbsForResolution(state.zoom * in.viewportSize.y));
+			const double scaleChange = (1.0 / oldZoom) - (1.0 / state.zoom);
+			const int limbs = state.offset.x.getFractionLimbs();
+			state.offset.x = state.offset.x + BigFixed::saturated(nx * aspect * scaleChange, limbs);
+			state.offset.y = state.offset.y + BigFixed::saturated(ny * scaleChange, limbs);
 		}
 	}
 
-	state.offset.x = std::clamp(state.offset.x, -m_panLimits.x, m_panLimits.x);
-	state.offset.y = std::clamp(state.offset.y, -m_panLimits.y, m_panLimits.y);
+	const BigFixed panLimitX = BigFixed::saturated(m_panLimits.x, 0);
+	const BigFixed panLimitY = BigFixed::saturated(m_panLimits.y, 0);
+	state.offset.x = std::clamp(state.offset.x, -panLimitX, panLimitX);
+	state.offset.y = std::clamp(state.offset.y, -panLimitY, panLimitY);
 }
@@ -28,6 +28,8 @@ class CameraController
 		double m_zoomSpeed;
 		double m_panSpeed;
 
-		glm::dvec2 m_zoomLimits{ 1e-2, 1e+12 };
+		glm::dvec2 m_zoomLimits{ 1e-2, 1e+300 };
 		glm::dvec2 m_panLimits{ 100.0, 100.0 };
+		// Sub-pixel part of the drag not applied yet; pans move by whole pixels so the last frame can be reused.
+		glm::dvec2 m_panRemainder{ 0.0, 0.0 };
 };
@@ -13,6 +13,8 @@
 #include <string>
 
 #include "fractal/FractalDefinition.hpp"
+#include "fractal/Keyframes.hpp"
+#include "fractal/PaletteLut.hpp"
 #include "ui/Icons.hpp"
 #include "ui/Theme.hpp"
 #include "util/FileUtils.hpp"
@@ -55,6 +57,7 @@ namespace
 		const auto PROPERTIES_WINDOW_TITLE = ICON_FA_SLIDERS " Properties";
 		const auto EXPORT_WINDOW_TITLE = ICON_FA_CAMERA " Export";
 		const auto COLORING_WINDOW_TITLE = ICON_FA_PALETTE " Coloring";
+		const auto ANIMATION_WINDOW_TITLE = ICON_FA_FILM " Animation";
 		const auto FILE_SAVE_PRESET = ICON_FA_FLOPPY_DISK " Save Preset...";
 		const auto FILE_LOAD_PRESET = ICON_FA_FOLDER_OPEN " Load Preset...";
 		const auto FILE_EXPORT_IMAGE = ICON_FA_FILE_EXPORT " Export Image...";
@@ -63,6 +66,9 @@ namespace
 		const auto HELP_ABOUT = ICON_FA_CIRCLE_INFO " About";
 		const auto EXPORT_SAVE_BUTTON = ICON_FA_FLOPPY_DISK " Save to File";
 		const auto SAVE_TO_FILE_BUTTON = ICON_FA_FLOPPY_DISK " Save to File";
+		const auto ADD_KEYFRAME_BUTTON = ICON_FA_PLUS " Add Keyframe";
+		const auto DELETE_KEYFRAME_BUTTON = ICON_FA_TRASH;
+		const auto CANCEL_EXPORT_BUTTON = "Cancel Export";
 
 		// Layout & Sizing
 		constexpr ImVec2 NO_PADDING = { 0.0F, 0.0F };
@@ -99,24 +105,80 @@ namespace
 		constexpr int MIN_ITERATIONS = 32;
 		constexpr int MAX_ITERATIONS = 32768;
 		constexpr double ZOOM_SPEED = 1.25;
-		constexpr float EPSILON = 1e-6F;
 		constexpr double JULIA_PARAM_STEP = 0.001;
 
 		// Formatting Strings
 		constexpr auto ZOOM_FORMAT = "%.3e";
-		constexpr auto COORD_FORMAT = "%.15f";
+		constexpr int MIN_COORD_DIGITS = 15;
+		constexpr int COORD_GUARD_DIGITS = 3;
 		constexpr auto JULIA_PARAM_FORMAT = "%.4f";
 		constexpr auto STATUS_BAR_FORMAT = "X: %.6f, Y: %.6f | Zoom: %.2e | Res: %dx%d";
+		constexpr auto STATUS_BAR_CPU_FORMAT = "| CPU (%.*s): %.1f ms, %.1f Mpx/s";
+		constexpr auto STATUS_BAR_GPU_FORMAT = "| GPU: %.1f ms/frame";
+		constexpr auto STATUS_BAR_PRECISION_FORMAT = "| %.*s";
+		constexpr auto STATUS_BAR_PERTURBATION_FORMAT = "(%d ref iters, %d bits)";
+		constexpr auto STATUS_BAR_BLA_TEXT = "+ BLA";
+		constexpr auto VALIDATE_SKIPPING_BUTTON = "Validate Against Full Iteration";
+		constexpr auto SKIPPING_REPORT_FORMAT = "Last check (%dx%d): %.2f%% pixels differ, %.1f%% iterations skipped";
+		constexpr auto COMPARE_SCHEDULING_BUTTON = "Compare Against Fixed Grid";
+		constexpr auto SCHEDULING_REPORT_FORMAT = "Last check (%dx%d): fixed grid %.2f ms, persistent %.2f ms (%.2fx)";
+		constexpr auto RENDER_JOBS_FORMAT = "Views: %llu rendered, %llu dropped, %llu cut short";
+		constexpr auto SUBDIVISION_REPORT_FORMAT = "%.1f%% of pixels filled without iterating";
+		constexpr auto CPU_WORKERS_HEADER = "CPU Workers";
+		constexpr auto WORKER_OVERLAY_FORMAT = "#{}: {:.0f}% ({} tasks, {} stolen)";
+
+		// Export
+		constexpr std::array<const char*, 7> EXPORT_SCALES = { "1x", "2x", "4x", "8x", "16x", "32x", "64x" };
+		constexpr int UNTILED_EXPORT_SCALES = 4; // Up to 8x; larger exports need tiling to fit in memory.
+		constexpr std::array<const char*, 4> SUPERSAMPLE_FACTORS = { "Off", "2x2", "4x4", "8x8" };
+		constexpr std::array<const char*, 3> RESOLVE_FILTER_NAMES = { "Box", "Mitchell", "Lanczos" };
+		constexpr auto EXPORT_SIZE_FORMAT = "Output: %d x %d";
+		constexpr auto TILED_PROGRESS_FORMAT = "{} / {} rows";
 
 		// Status Bar
 		constexpr ImVec2 STATUS_BAR_PADDING = { 12.0F, 5.0F };
 		constexpr int STATUS_BAR_STYLES_TO_POP = 2;
 
+		// Animation
+		constexpr float ANIMATION_TIME_STEP = 0.05F;
+		constexpr double KEYFRAME_TIME_TOLERANCE = 1e-3; // Keyframes closer than this share a slot on the timeline.
+		constexpr auto ANIMATION_TIME_FORMAT = "%.2f s";
+		constexpr auto KEYFRAME_LABEL_FORMAT = "{:.2f} s | {} | Zoom {:.2e}";
+		constexpr auto ANIMATION_PROGRESS_FORMAT = "{} / {} frames";
+		constexpr auto RENDER_ANIMATION_FORMAT = "{} Render {} Frames"; // Icon, frame count.
+		constexpr int MAX_ANIMATION_FPS = 240;
+		constexpr int MIN_ANIMATION_SIZE = 16;
+		constexpr int MAX_ANIMATION_SIZE = 16384;
+
 		// Exporting
+		constexpr std::array<const char*, 3> IMAGE_FORMAT_NAMES = { "PNG", "JPG", "BMP" };
 		constexpr auto PNG_EXTENSION = ".png";
 		constexpr auto JPG_EXTENSION = ".jpg";
 		constexpr auto BMP_EXTENSION = ".bmp";
 	} // namespace ui_constants
+
+	// Edits an arbitrary-precision coordinate as decimal text, showing enough digits to resolve a pixel at the
+	// current zoom. The value only changes once Enter is pressed on text that parses.
+	bool inputCoordinate(const char* label, BigFixed& value, double zoom, int viewHeight)
+	{
+		const double pixelsPerUnit = zoom * std::max(viewHeight, 1);
+		const int digits = std::max(ui_constants::MIN_COORD_DIGITS,
+									static_cast<int>(std::ceil(std::log10(std::max(pixelsPerUnit, 1.0))))
+										+ ui_constants::COORD_GUARD_DIGITS);
+
+		std::string text = value.toDecimalString(digits);
+		if (!ImGui::InputText(label, &text, ImGuiInputTextFlags_EnterReturnsTrue))
+			return false;
+
+		auto parsed = BigFixed::fromString(text);
+		if (!parsed)
+		{
+			FRACTAL_WARN("Ignoring invalid coordinate '{}'", text);
+			return false;
+		}
+		value = parsed->withPrecision(std::max(value.getFractionLimbs(), parsed->getFractionLimbs()));
+		return true;
+	}
 } // namespace
 
 UIManager::UIManager(SDL_Window* window, SDL_GLContext context) 
@@ -207,7 +269,7 @@ void UIManager::processEvent(const SDL_Event& event)
 	ImGui_ImplSDL3_ProcessEvent(&event);
 }
 
-void UIManager::update(FractalState& state, UIState& uiState, FractalComputer& computer)
+void UIManager::update(FractalState& state, UIState& uiState, const RenderStats& stats, GLuint textureID)
 {
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplSDL3_NewFrame();
@@ -231,17 +293,19 @@ void UIManager::update(FractalState& state, UIState& uiState, FractalComputer& c
 	setupDockspace(uiState);
 
 	if (uiState.showPropertiesPanel)
-		drawPropertiesPanel(state);
+		drawPropertiesPanel(state, stats);
 	if (uiState.showColoringPanel)
 		drawColoringPanel(state);
 	if (uiState.showExportPanel)
-		drawExportPanel(uiState);
+		drawExportPanel(state, uiState);
+	if (uiState.showAnimationPanel)
+		drawAnimationPanel(state, uiState);
 	if (uiState.showAboutModal)
 		drawAboutModal(uiState);
 	if (uiState.showStatusBar)
-		drawStatusBar(state);
+		drawStatusBar(state, stats);
 
-	drawViewportPanel(state, uiState, computer.getTextureID());
+	drawViewportPanel(state, uiState, textureID);
 
 	ImGui::End();
 }
@@ -268,6 +332,7 @@ void UIManager::setupDockspace(UIState& uiState)
 		ImGui::DockBuilderDockWindow(ui_constants::PROPERTIES_WINDOW_TITLE, dockRight);
 		ImGui::DockBuilderDockWindow(ui_constants::COLORING_WINDOW_TITLE, dockRight);
 		ImGui::DockBuilderDockWindow(ui_constants::EXPORT_WINDOW_TITLE, dockRight);
+		ImGui::DockBuilderDockWindow(ui_constants::ANIMATION_WINDOW_TITLE, dockBottom);
 
 		ImGui::DockBuilderFinish(dockspaceID);
 	}
@@ -340,6 +405,7 @@ void UIManager::drawMainMenuBar(UIState& uiState)
 			ImGui::MenuItem(ui_constants::PROPERTIES_WINDOW_TITLE, nullptr, &uiState.showPropertiesPanel);
 			ImGui::MenuItem(ui_constants::COLORING_WINDOW_TITLE, nullptr, &uiState.showColoringPanel);
 			ImGui::MenuItem(ui_constants::EXPORT_WINDOW_TITLE, nullptr, &uiState.showExportPanel);
+			ImGui::MenuItem(ui_constants::ANIMATION_WINDOW_TITLE, nullptr, &uiState.showAnimationPanel);
 			ImGui::MenuItem(ui_constants::VIEW_STATUS_BAR, nullptr, &uiState.showStatusBar);
 			ImGui::EndMenu();
 		}
@@ -460,7 +526,8 @@ void UIManager::drawViewportPanel(FractalState& state, const UIState& uiState, G
 			ImGuiIO& io = ImGui::GetIO();
 
 			CameraController::Input input;
-			input.viewportSize = { panelSize.x, panelSize.y };
+			// The render resolution rather than the fractional panel size, so pans land on whole pixels.
+			input.viewportSize = { static_cast<double>(state.renderWidth), static_cast<double>(state.renderHeight) };
 			input.mousePos = { io.MousePos.x - ImGui::GetItemRectMin().x, io.MousePos.y - ImGui::GetItemRectMin().y };
 			input.delta = { io.MouseDelta.x, io.MouseDelta.y };
 			input.dragging = ImGui::IsMouseDragging(ImGuiMouseButton_Left);
@@ -480,7 +547,7 @@ void UIManager::drawViewportPanel(FractalState& state, const UIState& uiState, G
 	ImGui::PopStyleVar();
 }
 
-void UIManager::drawPropertiesPanel(FractalState& state)
+void UIManager::drawPropertiesPanel(FractalState& state, const RenderStats& stats)
 {
 	ImGui::Begin(ui_constants::PROPERTIES_WINDOW_TITLE);
 	bool changed = false;
@@ -498,11 +565,50 @@ void UIManager::drawPropertiesPanel(FractalState& state)
 		ImGui::EndCombo();
 	}
 
+	static constexpr std::array<const char*, 2> s_backends = { "GPU (Compute Shader)", "CPU (SIMD)" };
+	int backendIdx = static_cast<int>(state.backend);
+	if (ImGui::Combo("Backend", &backendIdx, s_backends.data(), static_cast<int>(s_backends.size())))
+	{
+		state.backend = static_cast<RenderBackend>(backendIdx);
+		changed = true;
+	}
+	ImGui::BeginDisabled(state.backend != RenderBackend::GPU);
+	changed |= ImGui::Checkbox("Progressive Refinement", &state.progressiveRendering);
+	ImGui::EndDisabled();
+	ImGui::SetItemTooltip("GPU backend only. Shows a pass as coarse as the frame budget needs immediately and refines "
+						  "it to full resolution over the next frames, so heavy views stay responsive while you "
+						  "navigate.");
+
+	ImGui::BeginDisabled(state.backend != RenderBackend::GPU);
+	changed |= ImGui::Checkbox("Persistent Threads", &state.persistentThreads);
+	ImGui::EndDisabled();
+	ImGui::SetItemTooltip("GPU backend only. Launches a fixed set of workgroups that take tiles off a queue, the ones "
+						  "that were slowest last time first, so slow tiles along the set boundary do not leave the "
+						  "rest of the GPU idle.");
+	ImGui::BeginDisabled(state.backend != RenderBackend::GPU);
+	if (ImGui::Button(ui_constants::COMPARE_SCHEDULING_BUTTON, ui_constants::FULL_WIDTH_BUTTON)
+		&& onCompareTileScheduling)
+		onCompareTileScheduling();
+	ImGui::EndDisabled();
+
+	const TileSchedulingReport& scheduling = stats.schedulingReport;
+	if (scheduling.valid)
+	{
+		ImGui::TextWrapped(ui_constants::SCHEDULING_REPORT_FORMAT, scheduling.width, scheduling.height,
+						   scheduling.fixedGridMilliseconds, scheduling.persistentMilliseconds,
+						   scheduling.fixedGridMilliseconds / std::max(scheduling.persistentMilliseconds, 1e-9));
+	}
+	ImGui::TextDisabled(ui_constants::RENDER_JOBS_FORMAT, static_cast<unsigned long long>(stats.jobs.started),
+						static_cast<unsigned long long>(stats.jobs.dropped),
+						static_cast<unsigned long long>(stats.jobs.cancelled));
+	ImGui::SetItemTooltip("Views replaced by a newer one before they started rendering are dropped; those replaced "
+						  "while still refining are cut short at the next row of tiles.");
+
 	changed |= ImGui::SliderInt("Max Iterations", &state.maxIterations, ui_constants::MIN_ITERATIONS,
 								ui_constants::MAX_ITERATIONS);
 	changed |= ImGui::InputDouble("Zoom", &state.zoom, 0.0, 0.0, ui_constants::ZOOM_FORMAT);
-	changed |= ImGui::InputDouble("Offset X", &state.offset.x, 0.0, 0.0, ui_constants::COORD_FORMAT);
-	changed |= ImGui::InputDouble("Offset Y", &state.offset.y, 0.0, 0.0, ui_constants::COORD_FORMAT);
+	changed |= inputCoordinate("Offset X", state.offset.x, state.zoom, state.renderHeight);
+	changed |= inputCoordinate("Offset Y", state.offset.y, state.zoom, state.renderHeight);
 
 	if (state.type == FractalType::Julia)
 	{
@@ -513,6 +619,49 @@ void UIManager::drawPropertiesPanel(FractalState& state)
 									  ui_constants::JULIA_PARAM_STEP, 0.0, ui_constants::JULIA_PARAM_FORMAT);
 	}
 
+	if (CpuFractalRenderer::supportsSubdivision(state.type))
+	{
+		ImGui::SeparatorText("Acceleration");
+		ImGui::BeginDisabled(state.backend != RenderBackend::CPU);
+		changed |= ImGui::Checkbox("Rectangle Subdivision", &state.useRectangleSubdivision);
+		ImGui::EndDisabled();
+		ImGui::SetItemTooltip("CPU backend only. Iterates the borders of ever smaller rectangles and fills those whose "
+							  "border has a single value. Thin details can occasionally be missed.");
+		if (stats.backend == RenderBackend::CPU && state.useRectangleSubdivision)
+			ImGui::Text(ui_constants::SUBDIVISION_REPORT_FORMAT, stats.filledPixelRatio * 100.0);
+	}
+
+	if (state.type == FractalType::Mandelbrot)
+	{
+		ImGui::SeparatorText("Deep Zoom");
+		changed |= ImGui::Checkbox("Iteration Skipping (BLA)", &state.useIterationSkipping);
+		ImGui::SetItemTooltip("Skips runs of iterations with validated linear approximations once perturbation is "
+							  "active. Turn off to compare against full iteration.");
+		if (ImGui::Button(ui_constants::VALIDATE_SKIPPING_BUTTON, ui_constants::FULL_WIDTH_BUTTON)
+			&& onValidateIterationSkipping)
+			onValidateIterationSkipping();
+
+		const IterationSkippingReport& report = stats.skippingReport;
+		if (report.valid)
+		{
+			ImGui::TextWrapped(ui_constants::SKIPPING_REPORT_FORMAT, report.width, report.height,
+							   report.mismatchedPixelRatio * 100.0, report.skippedIterationRatio * 100.0);
+		}
+	}
+
+	// Per-worker utilization of the last CPU frame; uneven bars mean the tiles are not being shared out well.
+	if (stats.backend == RenderBackend::CPU && !stats.workers.empty()
+		&& ImGui::CollapsingHeader(ui_constants::CPU_WORKERS_HEADER))
+	{
+		for (size_t i = 0; i < stats.workers.size(); ++i)
+		{
+			const WorkerStats& worker = stats.workers[i];
+			const std::string overlay = std::format(ui_constants::WORKER_OVERLAY_FORMAT, i, worker.utilization * 100.0,
+													worker.tasksExecuted, worker.tasksStolen);
+			ImGui::ProgressBar(static_cast<float>(worker.utilization), ui_constants::FULL_WIDTH_BUTTON, overlay.c_str());
+		}
+	}
+
 	if (changed && onRequestRedraw)
 		onRequestRedraw();
 	ImGui::End();
@@ -545,43 +694,7 @@ void UIManager::updateGradientTexture(const std::vector<ColorStop>& palette)
 		return;
 
 	const int textureSize = ui_constants::GRADIENT_TEXTURE_SIZE;
-	std::vector<glm::vec3> gradientData(textureSize);
-
-	auto sortedPalette = palette;
-	std::ranges::sort(sortedPalette);
-
-	if (sortedPalette.empty())
-		return;
-
-	for (int i = 0; i < textureSize; ++i)
-	{
-		float t = static_cast<float>(i) / (textureSize - 1);
-
-		if (t <= sortedPalette.front().position)
-		{
-			gradientData[i] = sortedPalette.front().color;
-			continue;
-		}
-		if (t >= sortedPalette.back().position)
-		{
-			gradientData[i] = sortedPalette.back().color;
-			continue;
-		}
-
-		for (size_t j = 0; j < sortedPalette.size() - 1; ++j)
-		{
-			const auto& s1 = sortedPalette[j];
-			const auto& s2 = sortedPalette[j + 1];
-			if (t >= s1.position && t <= s2.position)
-			{
-				float segmentT = (s2.position - s1.position < ui_constants::EPSILON)
-									 ? 0.0F
-									 : (t - s1.position) / (s2.position - s1.position);
-				gradientData[i] = glm::mix(s1.color, s2.color, segmentT);
-				break;
-			}
-		}
-	}
+	const std::vector<glm::vec3> gradientData = PaletteLut::bake(palette, textureSize);
 
 	glBindTexture(GL_TEXTURE_2D, m_gradientTexture);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -680,30 +793,61 @@ bool UIManager::drawPaletteEditor(FractalState& state)
 	return paletteChanged;
 }
 
-void UIManager::drawExportPanel(UIState& uiState)
+void UIManager::drawExportPanel(const FractalState& state, UIState& uiState)
 {
 	ImGui::Begin(ui_constants::EXPORT_WINDOW_TITLE);
+	ImGui::BeginDisabled(uiState.isExportingTiles);
 
 	ImGui::InputText("Filename", &uiState.screenshotFilename);
 
-	static constexpr std::array<const char*, 3> s_formats = { "PNG", "JPG", "BMP" };
-	ImGui::Combo("Format", reinterpret_cast<int*>(&uiState.screenshotFormat), s_formats.data(),
-				 static_cast<int>(s_formats.size()));
+	ImGui::Checkbox("Tiled", &uiState.tiledExport);
+	ImGui::SetItemTooltip("Renders the image tile by tile and streams it to a PNG, so its size is not limited by "
+						  "memory. Unlocks scales beyond 8x.");
+	if (!uiState.tiledExport)
+	{
+		const int maxScale = 1 << (ui_constants::UNTILED_EXPORT_SCALES - 1);
+		uiState.exportScale = std::min(uiState.exportScale, maxScale);
+	}
+
+	ImGui::BeginDisabled(uiState.tiledExport);
+	ImGui::Combo("Format", reinterpret_cast<int*>(&uiState.screenshotFormat), ui_constants::IMAGE_FORMAT_NAMES.data(),
+				 static_cast<int>(ui_constants::IMAGE_FORMAT_NAMES.size()));
+	ImGui::EndDisabled();
+
+	const int scaleCount = uiState.tiledExport ? static_cast<int>(ui_constants::EXPORT_SCALES.size())
+											   : ui_constants::UNTILED_EXPORT_SCALES;
+	int scaleIdx = static_cast<int>(log2(uiState.exportScale));
+	if (ImGui::Combo("Scale", &scaleIdx, ui_constants::EXPORT_SCALES.data(), scaleCount))
+	{
+		uiState.exportScale = 1 << scaleIdx;
+	}
 
-	static constexpr std::array<const char*, 4> s_factors = { "1x", "2x", "4x", "8x" };
 	int factorIdx = static_cast<int>(log2(uiState.supersampleFactor));
-	if (ImGui::Combo("Supersample", &factorIdx, s_factors.data(), static_cast<int>(s_factors.size())))
+	if (ImGui::Combo("Supersample", &factorIdx, ui_constants::SUPERSAMPLE_FACTORS.data(),
+					 static_cast<int>(ui_constants::SUPERSAMPLE_FACTORS.size())))
 	{
 		uiState.supersampleFactor = 1 << factorIdx;
 	}
+	ImGui::SetItemTooltip("Renders several samples per pixel and filters them down before saving.");
+
+	ImGui::BeginDisabled(uiState.supersampleFactor == 1);
+	ImGui::Combo("Filter", reinterpret_cast<int*>(&uiState.resolveFilter), ui_constants::RESOLVE_FILTER_NAMES.data(),
+				 static_cast<int>(ui_constants::RESOLVE_FILTER_NAMES.size()));
+	ImGui::EndDisabled();
+
+	ImGui::TextDisabled(ui_constants::EXPORT_SIZE_FORMAT, state.renderWidth * uiState.exportScale,
+						state.renderHeight * uiState.exportScale);
 
 	if (ImGui::Button(ui_constants::SAVE_TO_FILE_BUTTON, ui_constants::FULL_WIDTH_BUTTON))
 	{
 		if (onRequestScreenshot)
 		{
 			ScreenshotRequest req;
+			req.scale = uiState.exportScale;
 			req.supersample = uiState.supersampleFactor;
-			req.format = uiState.screenshotFormat;
+			req.filter = uiState.resolveFilter;
+			req.format = uiState.tiledExport ? ScreenshotFormat::PNG : uiState.screenshotFormat;
+			req.tiled = uiState.tiledExport;
 
 			std::string extension;
 			switch (req.format)
@@ -723,10 +867,131 @@ void UIManager::drawExportPanel(UIState& uiState)
 			onRequestScreenshot(req);
 		}
 	}
+	ImGui::EndDisabled();
+
+	if (uiState.isExportingTiles)
+	{
+		const float progress = uiState.tiledRowCount > 0 ? static_cast<float>(uiState.tiledRowsWritten)
+															   / static_cast<float>(uiState.tiledRowCount)
+														 : 0.0F;
+		const std::string overlay = std::format(ui_constants::TILED_PROGRESS_FORMAT, uiState.tiledRowsWritten,
+												uiState.tiledRowCount);
+		ImGui::ProgressBar(progress, ui_constants::FULL_WIDTH_BUTTON, overlay.c_str());
+		if (ImGui::Button(ui_constants::CANCEL_EXPORT_BUTTON, ui_constants::FULL_WIDTH_BUTTON) && onCancelTiledExport)
+			onCancelTiledExport();
+	}
 	ImGui::End();
 }
 
-void UIManager::drawStatusBar(const FractalState& state)
+void UIManager::drawAnimationPanel(FractalState& state, UIState& uiState)
+{
+	ImGui::Begin(ui_constants::ANIMATION_WINDOW_TITLE);
+	auto& keyframes = uiState.keyframes;
+	bool moveToPlayhead = false;
+
+	ImGui::SeparatorText("Keyframes");
+	ImGui::DragScalar("Time", ImGuiDataType_Double, &uiState.animationTime, ui_constants::ANIMATION_TIME_STEP, nullptr,
+					  nullptr, ui_constants::ANIMATION_TIME_FORMAT);
+	uiState.animationTime = std::max(uiState.animationTime, 0.0);
+
+	if (ImGui::Button(ui_constants::ADD_KEYFRAME_BUTTON, ui_constants::FULL_WIDTH_BUTTON))
+	{
+		auto existing = std::ranges::find_if(keyframes, [&](const Keyframe& keyframe) {
+			return std::abs(keyframe.time - uiState.animationTime) < ui_constants::KEYFRAME_TIME_TOLERANCE;
+		});
+		if (existing != keyframes.end())
+			existing->state = state;
+		else
+			keyframes.insert(std::ranges::upper_bound(keyframes, uiState.animationTime, {}, &Keyframe::time),
+							 Keyframe{ .time = uiState.animationTime, .state = state });
+	}
+	ImGui::SetItemTooltip("Stores the current view at the playhead time, replacing a keyframe already there.");
+
+	int keyframeToDelete = -1;
+	for (size_t i = 0; i < keyframes.size(); ++i)
+	{
+		const Keyframe& keyframe = keyframes[i];
+		ImGui::PushID(static_cast<int>(i));
+		if (ImGui::SmallButton(ui_constants::DELETE_KEYFRAME_BUTTON))
+			keyframeToDelete = static_cast<int>(i);
+		ImGui::SameLine();
+
+		const std::string label = std::format(ui_constants::KEYFRAME_LABEL_FORMAT, keyframe.time,
+											  FractalDefinitions.at(keyframe.state.type).name, keyframe.state.zoom);
+		const bool atPlayhead
+			= std::abs(keyframe.time - uiState.animationTime) < ui_constants::KEYFRAME_TIME_TOLERANCE;
+		if (ImGui::Selectable(label.c_str(), atPlayhead))
+		{
+			uiState.animationTime = keyframe.time;
+			moveToPlayhead = true;
+		}
+		ImGui::PopID();
+	}
+	if (keyframeToDelete != -1)
+		keyframes.erase(keyframes.begin() + keyframeToDelete);
+
+	if (keyframes.size() >= 2)
+	{
+		ImGui::SeparatorText("Preview");
+		const double start = keyframes.front().time;
+		const double end = keyframes.back().time;
+		moveToPlayhead |= ImGui::SliderScalar("Playhead", ImGuiDataType_Double, &uiState.animationTime, &start, &end,
+											  ui_constants::ANIMATION_TIME_FORMAT);
+	}
+	if (moveToPlayhead)
+	{
+		Keyframes::apply(keyframes, uiState.animationTime, state);
+		if (onRequestRedraw)
+			onRequestRedraw();
+	}
+
+	ImGui::SeparatorText("Export");
+	ImGui::BeginDisabled(uiState.isExportingAnimation);
+	ImGui::InputText("Folder", &uiState.animationFolder);
+	ImGui::Combo("Frame Format", reinterpret_cast<int*>(&uiState.animationFormat),
+				 ui_constants::IMAGE_FORMAT_NAMES.data(), static_cast<int>(ui_constants::IMAGE_FORMAT_NAMES.size()));
+	if (ImGui::InputInt("Frames per Second", &uiState.animationFramesPerSecond))
+	{
+		uiState.animationFramesPerSecond
+			= std::clamp(uiState.animationFramesPerSecond, 1, ui_constants::MAX_ANIMATION_FPS);
+	}
+
+	std::array<int, 2> frameSize = { uiState.animationWidth, uiState.animationHeight };
+	if (ImGui::InputInt2("Frame Size", frameSize.data()))
+	{
+		uiState.animationWidth = std::clamp(frameSize[0], ui_constants::MIN_ANIMATION_SIZE,
+											ui_constants::MAX_ANIMATION_SIZE);
+		uiState.animationHeight = std::clamp(frameSize[1], ui_constants::MIN_ANIMATION_SIZE,
+											 ui_constants::MAX_ANIMATION_SIZE);
+	}
+	ImGui::EndDisabled();
+
+	if (uiState.isExportingAnimation)
+	{
+		const float progress = uiState.animationFrameCount > 0 ? static_cast<float>(uiState.animationFramesWritten)
+																	 / static_cast<float>(uiState.animationFrameCount)
+															   : 0.0F;
+		const std::string overlay = std::format(ui_constants::ANIMATION_PROGRESS_FORMAT, uiState.animationFramesWritten,
+												uiState.animationFrameCount);
+		ImGui::ProgressBar(progress, ui_constants::FULL_WIDTH_BUTTON, overlay.c_str());
+		if (ImGui::Button(ui_constants::CANCEL_EXPORT_BUTTON, ui_constants::FULL_WIDTH_BUTTON) && onCancelAnimation)
+			onCancelAnimation();
+	}
+	else
+	{
+		const int frameCount = Keyframes::getFrameCount(keyframes, uiState.animationFramesPerSecond);
+		const std::string label = std::format(ui_constants::RENDER_ANIMATION_FORMAT, ICON_FA_FILE_VIDEO, frameCount);
+		ImGui::BeginDisabled(keyframes.size() < 2);
+		if (ImGui::Button(label.c_str(), ui_constants::FULL_WIDTH_BUTTON) && onRenderAnimation)
+			onRenderAnimation();
+		ImGui::EndDisabled();
+		ImGui::SetItemTooltip("Renders every frame between the first and last keyframe with the current backend. "
+							  "The viewer stays usable while the frames are written.");
+	}
+	ImGui::End();
+}
+
+void UIManager::drawStatusBar(const FractalState& state, const RenderStats& stats)
 {
 	ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoDocking
 							 | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing
@@ -739,8 +1004,33 @@ void UIManager::drawStatusBar(const FractalState& state)
 
 	if (ImGui::BeginViewportSideBar("StatusBar", ImGui::GetMainViewport(), ImGuiDir_Down, height, flags))
 	{
-		ImGui::Text(ui_constants::STATUS_BAR_FORMAT, state.offset.x, state.offset.y, state.zoom, state.renderWidth,
+		const glm::dvec2 center = state.offset.toDouble();
+		ImGui::Text(ui_constants::STATUS_BAR_FORMAT, center.x, center.y, state.zoom, state.renderWidth,
 					state.renderHeight);
+		ImGui::SameLine();
+		if (stats.backend == RenderBackend::CPU)
+		{
+			ImGui::Text(ui_constants::STATUS_BAR_CPU_FORMAT, static_cast<int>(stats.cpuIsa.size()),
+						stats.cpuIsa.data(), stats.milliseconds, stats.megapixelsPerSecond);
+		}
+		else
+		{
+			ImGui::Text(ui_constants::STATUS_BAR_GPU_FORMAT, stats.gpuFrameMilliseconds);
+		}
+		const std::string_view precision = getPrecisionName(stats.precision);
+		ImGui::SameLine();
+		ImGui::Text(ui_constants::STATUS_BAR_PRECISION_FORMAT, static_cast<int>(precision.size()), precision.data());
+		if (stats.precision == KernelPrecision::Perturbation)
+		{
+			ImGui::SameLine();
+			ImGui::Text(ui_constants::STATUS_BAR_PERTURBATION_FORMAT, stats.referenceIterations,
+						stats.referencePrecisionBits);
+			if (stats.iterationSkipping)
+			{
+				ImGui::SameLine();
+				ImGui::TextUnformatted(ui_constants::STATUS_BAR_BLA_TEXT);
+			}
+		}
 		ImGui::End();
 	}
 	ImGui::PopStyleVar(ui_constants::STATUS_BAR_STYLES_TO_POP);
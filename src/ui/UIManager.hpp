@@ -18,15 +18,21 @@ class UIManager
 		~UIManager();
 
 		void processEvent(const SDL_Event& event);
-		void update(FractalState& state, UIState& uiState, FractalComputer& computer);
+		// `stats` and `textureID` come from the newest frame the render thread finished.
+		void update(FractalState& state, UIState& uiState, const RenderStats& stats, GLuint textureID);
 		void render();
 
 		// Callbacks to request actions from the main Application class.
 		std::function<void()> onRequestRedraw;
 		std::function<void(const ScreenshotRequest&)> onRequestScreenshot;
+		std::function<void()> onValidateIterationSkipping;
+		std::function<void()> onCompareTileScheduling;
 		std::function<void()> onQuit;
 		std::function<void()> onSavePreset;
 		std::function<void()> onLoadPreset;
+		std::function<void()> onRenderAnimation;
+		std::function<void()> onCancelAnimation;
+		std::function<void()> onCancelTiledExport;
 
 	private:
 		void setupFonts();
@@ -35,11 +41,12 @@ class UIManager
 		void drawMainMenuBar(UIState& uiState);
 		void drawAboutModal(UIState& uiState);
 		void drawViewportPanel(FractalState& state, const UIState& uiState, GLuint textureID);
-		void drawPropertiesPanel(FractalState& state);
+		void drawPropertiesPanel(FractalState& state, const RenderStats& stats);
 		void drawColoringPanel(FractalState& state);
 		bool drawPaletteEditor(FractalState& state);
-		void drawExportPanel(UIState& uiState);
-		void drawStatusBar(const FractalState& state);
+		void drawExportPanel(const FractalState& state, UIState& uiState);
+		void drawAnimationPanel(FractalState& state, UIState& uiState);
+		void drawStatusBar(const FractalState& state, const RenderStats& stats);
 
 		ImFont* m_fontBold = nullptr;
 
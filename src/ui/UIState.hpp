@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "fractal/FractalState.hpp"
+#include "fractal/Keyframes.hpp"
 
 enum class ScreenshotFormat
 {
@@ -13,17 +14,23 @@ enum class ScreenshotFormat
 	BMP
 };
 
-struct ScreenshotRequest
+// Filter that turns supersamples into output pixels: a plain average of the samples inside the pixel, the soft
+// Mitchell-Netravali cubic (B = C = 1/3), or the sharper Lanczos-3, which rings slightly at hard edges.
+enum class ResolveFilter
 {
-		std::filesystem::path filepath;
-		ScreenshotFormat format = ScreenshotFormat::PNG;
-		int supersample = 1;
+	Box,
+	Mitchell,
+	Lanczos
 };
 
-struct Keyframe
+struct ScreenshotRequest
 {
-		double time;
-		FractalState state;
+		std::filesystem::path filepath;
+		ScreenshotFormat format = ScreenshotFormat::PNG;
+		int scale = 1;		 // Output size as a multiple of the view size.
+		int supersample = 1; // Samples per output pixel along each axis, filtered down before the image is saved.
+		ResolveFilter filter = ResolveFilter::Mitchell;
+		bool tiled = false; // Rendered tile by tile and streamed to disk; always PNG.
 };
 
 struct UIState
@@ -37,5 +44,26 @@ struct UIState
 
 		std::string screenshotFilename = "fractavistas_shot";
 		ScreenshotFormat screenshotFormat = ScreenshotFormat::PNG;
+		int exportScale = 1;
 		int supersampleFactor = 1;
+		ResolveFilter resolveFilter = ResolveFilter::Mitchell;
+		bool tiledExport = false;
+
+		// Progress of the running tiled export, updated by the application every frame.
+		bool isExportingTiles = false;
+		int tiledRowsWritten = 0;
+		int tiledRowCount = 0;
+
+		std::vector<Keyframe> keyframes; // Sorted by time.
+		double animationTime = 0.0;		 // Playhead, in seconds.
+		std::string animationFolder = "fractavista_animation";
+		ScreenshotFormat animationFormat = ScreenshotFormat::PNG;
+		int animationFramesPerSecond = 30;
+		int animationWidth = 1920;
+		int animationHeight = 1080;
+
+		// Progress of the running animation export, updated by the application every frame.
+		bool isExportingAnimation = false;
+		int animationFramesWritten = 0;
+		int animationFrameCount = 0;
 };
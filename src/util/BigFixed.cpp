@@ -0,0 +1,501 @@
+#include "BigFixed.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <format>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	constexpr double LIMB_SCALE = 4294967296.0; // 2^32
+	// Magnitudes from here on have no integer limb to go to.
+	constexpr double INTEGER_RANGE = LIMB_SCALE;
+	static_assert(BigFixed::INTEGER_LIMBS == 1, "INTEGER_RANGE assumes a single integer limb");
+	constexpr int HEX_DIGITS_PER_LIMB = 8;
+	constexpr double BITS_PER_DECIMAL_DIGIT = 3.321928094887362;
+	// Bits kept beyond the pixel spacing so coordinate rounding never shows up on screen.
+	constexpr int GUARD_BITS = 64;
+	constexpr int MIN_FRACTION_LIMBS = 2; // As FractalState::DEFAULT_COORDINATE_LIMBS.
+	// Keeps a hostile exponent in a preset from expanding into gigabytes of digits.
+	constexpr int MAX_DECIMAL_EXPONENT = 100000;
+
+	int hexValue(char c)
+	{
+		if (c >= '0' && c <= '9')
+			return c - '0';
+		if (c >= 'a' && c <= 'f')
+			return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F')
+			return c - 'A' + 10;
+		return -1;
+	}
+
+	bool isDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+}
+
+int BigFixed::limbsForResolution(double pixelsPerUnit)
+{
+	const double bits = std::ceil(std::log2(std::max(1.0, pixelsPerUnit)));
+	return std::max(MIN_FRACTION_LIMBS, limbsForBits(static_cast<int>(bits) + GUARD_BITS));
+}
+
+BigFixed::BigFixed(double value, int fractionLimbs)
+	: m_negative(value < 0.0), m_fractionLimbs(std::max(0, fractionLimbs)),
+	  m_limbs(static_cast<size_t>(m_fractionLimbs + INTEGER_LIMBS), 0)
+{
+	if (!isRepresentable(value))
+		throw std::out_of_range(std::format("{} is outside the range of a fixed-point coordinate", value));
+
+	// Peel off 32 bits at a time from the top; every step is exact because a double has only 53 mantissa bits.
+	double remaining = std::fabs(value);
+	for (size_t i = m_limbs.size(); i-- > 0;)
+	{
+		const double limb = std::floor(remaining);
+		m_limbs[i] = static_cast<uint32_t>(limb);
+		remaining = (remaining - limb) * LIMB_SCALE;
+		if (remaining == 0.0)
+			break;
+	}
+	normalizeZero();
+}
+
+BigFixed BigFixed::saturated(double value, int fractionLimbs)
+{
+	if (std::isnan(value))
+		return { 0.0, fractionLimbs };
+	// The largest double below 2^32 still converts exactly.
+	const double limit = std::nextafter(INTEGER_RANGE, 0.0);
+	return { std::clamp(value, -limit, limit), fractionLimbs };
+}
+
+bool BigFixed::isRepresentable(double value)
+{
+	// NaN fails the comparison as well.
+	return std::fabs(value) < INTEGER_RANGE;
+}
+
+double BigFixed::toDouble() const
+{
+	double result = 0.0;
+	for (size_t i = m_limbs.size(); i-- > 0;)
+	{
+		if (m_limbs[i] != 0)
+		{
+			result += std::ldexp(static_cast<double>(m_limbs[i]),
+								 LIMB_BITS * (static_cast<int>(i) - m_fractionLimbs));
+		}
+	}
+	return m_negative ? -result : result;
+}
+
+std::optional<BigFixed> BigFixed::fromString(std::string_view text)
+{
+	while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front())))
+		text.remove_prefix(1);
+	while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back())))
+		text.remove_suffix(1);
+
+	bool negative = false;
+	if (!text.empty() && (text.front() == '-' || text.front() == '+'))
+	{
+		negative = text.front() == '-';
+		text.remove_prefix(1);
+	}
+
+	if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X'))
+		return fromHexString(text.substr(2), negative);
+	return fromDecimalString(text, negative);
+}
+
+std::optional<BigFixed> BigFixed::fromHexString(std::string_view digits, bool negative)
+{
+	const size_t point = digits.find('.');
+	std::string_view integerDigits = digits.substr(0, point);
+	const std::string_view fractionDigits = point == std::string_view::npos ? std::string_view{} : digits.substr(point + 1);
+	if (integerDigits.empty() && fractionDigits.empty())
+		return std::nullopt;
+
+	while (integerDigits.size() > 1 && integerDigits.front() == '0')
+		integerDigits.remove_prefix(1);
+	if (integerDigits.size() > static_cast<size_t>(HEX_DIGITS_PER_LIMB))
+		return std::nullopt;
+
+	BigFixed result(0.0, static_cast<int>((fractionDigits.size() + HEX_DIGITS_PER_LIMB - 1) / HEX_DIGITS_PER_LIMB));
+	result.m_negative = negative;
+
+	uint32_t integer = 0;
+	for (const char c : integerDigits)
+	{
+		const int value = hexValue(c);
+		if (value < 0)
+			return std::nullopt;
+		integer = (integer << 4) | static_cast<uint32_t>(value);
+	}
+	result.m_limbs[static_cast<size_t>(result.m_fractionLimbs)] = integer;
+
+	for (size_t i = 0; i < fractionDigits.size(); ++i)
+	{
+		const int value = hexValue(fractionDigits[i]);
+		if (value < 0)
+			return std::nullopt;
+		const size_t limb = static_cast<size_t>(result.m_fractionLimbs) - 1 - (i / HEX_DIGITS_PER_LIMB);
+		const int shift = LIMB_BITS - 4 - (4 * static_cast<int>(i % HEX_DIGITS_PER_LIMB));
+		result.m_limbs[limb] |= static_cast<uint32_t>(value) << shift;
+	}
+
+	result.normalizeZero();
+	return result;
+}
+
+std::optional<BigFixed> BigFixed::fromDecimalString(std::string_view digits, bool negative)
+{
+	// Split into a bare digit string and the position of the decimal point within it.
+	std::string mantissa;
+	long long pointPosition = -1;
+	size_t pos = 0;
+	for (; pos < digits.size(); ++pos)
+	{
+		const char c = digits[pos];
+		if (isDigit(c))
+			mantissa.push_back(c);
+		else if (c == '.' && pointPosition < 0)
+			pointPosition = static_cast<long long>(mantissa.size());
+		else
+			break;
+	}
+	if (mantissa.empty())
+		return std::nullopt;
+	if (pointPosition < 0)
+		pointPosition = static_cast<long long>(mantissa.size());
+
+	if (pos < digits.size() && (digits[pos] == 'e' || digits[pos] == 'E'))
+	{
+		++pos;
+		bool negativeExponent = false;
+		if (pos < digits.size() && (digits[pos] == '-' || digits[pos] == '+'))
+			negativeExponent = digits[pos++] == '-';
+		if (pos >= digits.size())
+			return std::nullopt;
+
+		long long exponent = 0;
+		for (; pos < digits.size() && isDigit(digits[pos]); ++pos)
+		{
+			exponent = (exponent * 10) + (digits[pos] - '0');
+			if (exponent > MAX_DECIMAL_EXPONENT)
+				return std::nullopt;
+		}
+		pointPosition += negativeExponent ? -exponent : exponent;
+	}
+	if (pos != digits.size())
+		return std::nullopt;
+
+	// Shift the point into range by padding with zeros on whichever side it fell off.
+	if (pointPosition < 0)
+	{
+		mantissa.insert(0, static_cast<size_t>(-pointPosition), '0');
+		pointPosition = 0;
+	}
+	if (pointPosition > static_cast<long long>(mantissa.size()))
+		mantissa.append(static_cast<size_t>(pointPosition) - mantissa.size(), '0');
+
+	const std::string_view integerDigits = std::string_view(mantissa).substr(0, static_cast<size_t>(pointPosition));
+	std::string_view fractionDigits = std::string_view(mantissa).substr(static_cast<size_t>(pointPosition));
+	while (!fractionDigits.empty() && fractionDigits.back() == '0')
+		fractionDigits.remove_suffix(1);
+
+	uint64_t integer = 0;
+	for (const char c : integerDigits)
+	{
+		integer = (integer * 10) + static_cast<uint64_t>(c - '0');
+		if (integer > UINT32_MAX)
+			return std::nullopt;
+	}
+
+	// Most decimal fractions have no finite binary expansion, so the digit count alone is too little: "0.1" would
+	// get one limb and land 1.4e-10 off. Every result has at least a coordinate's limbs and one more to spare.
+	const int digitLimbs = limbsForBits(
+		static_cast<int>(std::ceil(static_cast<double>(fractionDigits.size()) * BITS_PER_DECIMAL_DIGIT)));
+	const int fractionLimbs = std::max(MIN_FRACTION_LIMBS, digitLimbs) + 1;
+
+	// Horner's scheme from the last digit: x = (digit + x) / 10, with one guard limb to absorb the truncation
+	// of each division; the guard limb is rounded off at the end.
+	BigFixed fraction(0.0, fractionLimbs + 1);
+	const size_t integerLimb = fraction.m_limbs.size() - 1;
+	for (auto it = fractionDigits.rbegin(); it != fractionDigits.rend(); ++it)
+	{
+		fraction.m_limbs[integerLimb] += static_cast<uint32_t>(*it - '0');
+		uint64_t remainder = 0;
+		for (size_t i = fraction.m_limbs.size(); i-- > 0;)
+		{
+			const uint64_t current = (remainder << LIMB_BITS) | fraction.m_limbs[i];
+			fraction.m_limbs[i] = static_cast<uint32_t>(current / 10);
+			remainder = current % 10;
+		}
+	}
+
+	BigFixed result = fraction.withPrecision(fractionLimbs);
+	result.m_limbs[static_cast<size_t>(fractionLimbs)] = static_cast<uint32_t>(integer);
+	result.m_negative = negative;
+	result.normalizeZero();
+	return result;
+}
+
+std::string BigFixed::toHexString() const
+{
+	static constexpr char HEX_CHARS[] = "0123456789ABCDEF";
+
+	std::string text = m_negative ? "-0x" : "0x";
+
+	const uint32_t integer = m_limbs[static_cast<size_t>(m_fractionLimbs)];
+	std::string integerDigits;
+	for (uint32_t value = integer; value != 0; value >>= 4)
+		integerDigits.insert(integerDigits.begin(), HEX_CHARS[value & 0xF]);
+	text += integerDigits.empty() ? "0" : integerDigits;
+
+	std::string fractionDigits;
+	for (size_t i = static_cast<size_t>(m_fractionLimbs); i-- > 0;)
+	{
+		for (int shift = LIMB_BITS - 4; shift >= 0; shift -= 4)
+			fractionDigits.push_back(HEX_CHARS[(m_limbs[i] >> shift) & 0xF]);
+	}
+	while (!fractionDigits.empty() && fractionDigits.back() == '0')
+		fractionDigits.pop_back();
+
+	if (!fractionDigits.empty())
+		text += "." + fractionDigits;
+	return text;
+}
+
+std::string BigFixed::toDecimalString(int maxFractionDigits) const
+{
+	std::string text = m_negative ? "-" : "";
+	text += std::to_string(m_limbs[static_cast<size_t>(m_fractionLimbs)]);
+
+	// Repeatedly multiply the fraction by ten; the carry out of the top limb is the next digit.
+	std::vector<uint32_t> fraction(m_limbs.begin(), m_limbs.begin() + m_fractionLimbs);
+	size_t lowest = 0;
+	std::string fractionDigits;
+	while (maxFractionDigits < 0 || static_cast<int>(fractionDigits.size()) < maxFractionDigits)
+	{
+		while (lowest < fraction.size() && fraction[lowest] == 0)
+			++lowest;
+		if (lowest == fraction.size())
+			break;
+
+		uint64_t carry = 0;
+		for (size_t i = lowest; i < fraction.size(); ++i)
+		{
+			const uint64_t product = (static_cast<uint64_t>(fraction[i]) * 10) + carry;
+			fraction[i] = static_cast<uint32_t>(product);
+			carry = product >> LIMB_BITS;
+		}
+		fractionDigits.push_back(static_cast<char>('0' + carry));
+	}
+	while (!fractionDigits.empty() && fractionDigits.back() == '0')
+		fractionDigits.pop_back();
+
+	if (!fractionDigits.empty())
+		text += "." + fractionDigits;
+	return text;
+}
+
+bool BigFixed::isZero() const
+{
+	return std::ranges::all_of(m_limbs, [](uint32_t limb) { return limb == 0; });
+}
+
+BigFixed BigFixed::withPrecision(int fractionLimbs) const
+{
+	fractionLimbs = std::max(0, fractionLimbs);
+	if (fractionLimbs == m_fractionLimbs)
+		return *this;
+
+	BigFixed result;
+	result.m_negative = m_negative;
+	result.m_fractionLimbs = fractionLimbs;
+	result.m_limbs.assign(static_cast<size_t>(fractionLimbs + INTEGER_LIMBS), 0);
+
+	// Align on the binary point.
+	const int shift = fractionLimbs - m_fractionLimbs;
+	for (size_t i = 0; i < m_limbs.size(); ++i)
+	{
+		const int target = static_cast<int>(i) + shift;
+		if (target >= 0 && target < static_cast<int>(result.m_limbs.size()))
+			result.m_limbs[static_cast<size_t>(target)] = m_limbs[i];
+	}
+
+	// Dropped low limbs round the magnitude to nearest, ties away from zero. A carry out of the integer limb would
+	// wrap around, so the largest magnitude stays truncated instead.
+	if (shift < 0 && (m_limbs[static_cast<size_t>(-shift - 1)] & 0x80000000U) != 0
+		&& !std::ranges::all_of(result.m_limbs, [](uint32_t limb) { return limb == UINT32_MAX; }))
+	{
+		for (uint32_t& limb : result.m_limbs)
+		{
+			if (++limb != 0)
+				break;
+		}
+	}
+	result.normalizeZero();
+	return result;
+}
+
+BigFixed BigFixed::abs() const
+{
+	BigFixed result = *this;
+	result.m_negative = false;
+	return result;
+}
+
+BigFixed BigFixed::operator-() const
+{
+	BigFixed result = *this;
+	result.m_negative = !m_negative;
+	result.normalizeZero();
+	return result;
+}
+
+std::strong_ordering BigFixed::compareMagnitude(const Limbs& a, const Limbs& b)
+{
+	for (size_t i = a.size(); i-- > 0;)
+	{
+		if (a[i] != b[i])
+			return a[i] <=> b[i];
+	}
+	return std::strong_ordering::equal;
+}
+
+void BigFixed::addMagnitude(Limbs& a, const Limbs& b)
+{
+	uint64_t carry = 0;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		const uint64_t sum = static_cast<uint64_t>(a[i]) + b[i] + carry;
+		a[i] = static_cast<uint32_t>(sum);
+		carry = sum >> LIMB_BITS;
+	}
+}
+
+void BigFixed::subtractMagnitude(Limbs& a, const Limbs& b)
+{
+	uint64_t borrow = 0;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		const uint64_t subtrahend = static_cast<uint64_t>(b[i]) + borrow;
+		borrow = static_cast<uint64_t>(a[i]) < subtrahend ? 1 : 0;
+		a[i] = static_cast<uint32_t>((static_cast<uint64_t>(a[i]) + (borrow << LIMB_BITS)) - subtrahend);
+	}
+}
+
+void BigFixed::normalizeZero()
+{
+	if (m_negative && isZero())
+		m_negative = false;
+}
+
+BigFixed BigFixed::addSigned(const BigFixed& a, const BigFixed& b, bool negateB)
+{
+	const int precision = std::max(a.m_fractionLimbs, b.m_fractionLimbs);
+	BigFixed lhs = a.withPrecision(precision);
+	const BigFixed rhs = b.withPrecision(precision);
+	const bool rhsNegative = rhs.m_negative != negateB;
+
+	if (lhs.m_negative == rhsNegative)
+	{
+		addMagnitude(lhs.m_limbs, rhs.m_limbs);
+	}
+	else if (compareMagnitude(lhs.m_limbs, rhs.m_limbs) >= 0)
+	{
+		subtractMagnitude(lhs.m_limbs, rhs.m_limbs);
+	}
+	else
+	{
+		BigFixed result = rhs;
+		result.m_negative = rhsNegative;
+		subtractMagnitude(result.m_limbs, lhs.m_limbs);
+		result.normalizeZero();
+		return result;
+	}
+	lhs.normalizeZero();
+	return lhs;
+}
+
+BigFixed operator+(const BigFixed& a, const BigFixed& b)
+{
+	return BigFixed::addSigned(a, b, false);
+}
+
+BigFixed operator-(const BigFixed& a, const BigFixed& b)
+{
+	return BigFixed::addSigned(a, b, true);
+}
+
+BigFixed operator*(const BigFixed& a, const BigFixed& b)
+{
+	const int precision = std::max(a.m_fractionLimbs, b.m_fractionLimbs);
+	const BigFixed lhs = a.withPrecision(precision);
+	const BigFixed rhs = b.withPrecision(precision);
+	const size_t count = lhs.m_limbs.size();
+
+	// Schoolbook product; limb * limb + two limbs always fits in 64 bits.
+	BigFixed::ProductLimbs product(count * 2, 0);
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (lhs.m_limbs[i] == 0)
+			continue;
+
+		uint64_t carry = 0;
+		for (size_t j = 0; j < count; ++j)
+		{
+			const uint64_t term = static_cast<uint64_t>(lhs.m_limbs[i]) * rhs.m_limbs[j] + product[i + j] + carry;
+			product[i + j] = static_cast<uint32_t>(term);
+			carry = term >> BigFixed::LIMB_BITS;
+		}
+		product[i + count] = static_cast<uint32_t>(carry);
+	}
+
+	// The product carries twice the fraction limbs; dropping the lowest `precision` limbs truncates it back.
+	BigFixed result;
+	result.m_negative = lhs.m_negative != rhs.m_negative;
+	result.m_fractionLimbs = precision;
+	const auto first = product.begin() + precision;
+	result.m_limbs.assign(first, first + static_cast<std::ptrdiff_t>(count));
+	result.normalizeZero();
+	return result;
+}
+
+BigFixed operator*(const BigFixed& a, int b)
+{
+	BigFixed result = a;
+	result.m_negative = a.m_negative != (b < 0);
+
+	const uint64_t factor = static_cast<uint64_t>(std::abs(static_cast<int64_t>(b)));
+	uint64_t carry = 0;
+	for (uint32_t& limb : result.m_limbs)
+	{
+		const uint64_t term = static_cast<uint64_t>(limb) * factor + carry;
+		limb = static_cast<uint32_t>(term);
+		carry = term >> BigFixed::LIMB_BITS;
+	}
+	result.normalizeZero();
+	return result;
+}
+
+std::strong_ordering operator<=>(const BigFixed& a, const BigFixed& b)
+{
+	if (a.m_negative != b.m_negative)
+		return a.m_negative ? std::strong_ordering::less : std::strong_ordering::greater;
+
+	const int precision = std::max(a.m_fractionLimbs, b.m_fractionLimbs);
+	const std::strong_ordering magnitude
+		= BigFixed::compareMagnitude(a.withPrecision(precision).m_limbs, b.withPrecision(precision).m_limbs);
+	if (a.m_negative)
+		return 0 <=> magnitude;
+	return magnitude;
+}
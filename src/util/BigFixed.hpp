@@ -0,0 +1,80 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "SmallVector.hpp"
+
+// Arbitrary-precision signed fixed-point number: one 32-bit integer limb and a configurable number of 32-bit
+// fraction limbs, stored little-endian. Fractal coordinates and orbits stay well inside +-2^31, so fixed point
+// gives every bit to the fraction and keeps add/multiply simple. Operands of a binary operation are widened
+// to the larger precision of the two. Limbs live inline up to INLINE_LIMBS (about 70 decimal digits), so
+// typical view coordinates never allocate.
+class BigFixed
+{
+	public:
+		BigFixed() = default;
+		// Throws std::out_of_range unless isRepresentable(value).
+		BigFixed(double value, int fractionLimbs);
+		// Like the constructor, but saturates at the largest magnitude the integer limb holds and reads NaN as 0.
+		static BigFixed saturated(double value, int fractionLimbs);
+		// Whether `value` is finite and its integer part fits the integer limb.
+		static bool isRepresentable(double value);
+
+		// Accepts decimal ("-0.75", "1.25e-3") and hexadecimal ("-0x0.C") notation. Hex is exact; decimal is
+		// rounded to nearest, with a limb more than the given digits or a default view coordinate need.
+		static std::optional<BigFixed> fromString(std::string_view text);
+
+		[[nodiscard]] double toDouble() const;
+		// Exact hexadecimal representation, e.g. "-0x0.C"; round-trips through fromString bit for bit.
+		[[nodiscard]] std::string toHexString() const;
+		// Decimal representation truncated to maxFractionDigits (exact when negative, as every binary fraction has
+		// a finite decimal expansion).
+		[[nodiscard]] std::string toDecimalString(int maxFractionDigits = -1) const;
+		[[nodiscard]] int getFractionLimbs() const { return m_fractionLimbs; }
+		[[nodiscard]] bool isNegative() const { return m_negative; }
+		[[nodiscard]] bool isZero() const;
+
+		[[nodiscard]] BigFixed withPrecision(int fractionLimbs) const;
+		[[nodiscard]] BigFixed abs() const;
+		[[nodiscard]] BigFixed square() const { return *this * *this; }
+
+		BigFixed operator-() const;
+		friend BigFixed operator+(const BigFixed& a, const BigFixed& b);
+		friend BigFixed operator-(const BigFixed& a, const BigFixed& b);
+		friend BigFixed operator*(const BigFixed& a, const BigFixed& b);
+		friend BigFixed operator*(const BigFixed& a, int b);
+
+		friend std::strong_ordering operator<=>(const BigFixed& a, const BigFixed& b);
+		friend bool operator==(const BigFixed& a, const BigFixed& b) { return (a <=> b) == 0; }
+
+		static constexpr int INTEGER_LIMBS = 1;
+		static constexpr int LIMB_BITS = 32;
+		static constexpr size_t INLINE_LIMBS = 8;
+
+		// Fraction limbs needed to resolve `bits` bits after the binary point.
+		static int limbsForBits(int bits) { return (bits + LIMB_BITS - 1) / LIMB_BITS; }
+		// Fraction limbs for coordinates of a view with this many pixels per unit, with guard bits to spare so
+		// rounding never reaches pixel scale.
+		static int limbsForResolution(double pixelsPerUnit);
+
+	private:
+		using Limbs = SmallVector<uint32_t, INLINE_LIMBS>;
+		using ProductLimbs = SmallVector<uint32_t, INLINE_LIMBS * 2>;
+
+		static std::optional<BigFixed> fromHexString(std::string_view digits, bool negative);
+		static std::optional<BigFixed> fromDecimalString(std::string_view digits, bool negative);
+
+		static std::strong_ordering compareMagnitude(const Limbs& a, const Limbs& b);
+		static void addMagnitude(Limbs& a, const Limbs& b);
+		static void subtractMagnitude(Limbs& a, const Limbs& b); // Requires |a| >= |b|.
+		static BigFixed addSigned(const BigFixed& a, const BigFixed& b, bool negateB);
+		void normalizeZero();
+
+		bool m_negative = false;
+		int m_fractionLimbs = 0;
+		Limbs m_limbs = Limbs(INTEGER_LIMBS, 0);
+};
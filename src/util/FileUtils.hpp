@@ -3,12 +3,12 @@
 #include <filesystem>
 #include <fstream>
 #include <optional>
-#include <regex>
-#include <set>
 #include <sstream>
 #include <string>
 
+#include <SDL3/SDL_error.h>
 #include <SDL3/SDL_filesystem.h>
+#include <SDL3/SDL_stdinc.h>
 
 #include "Logger.hpp"
 
@@ -36,6 +36,21 @@ namespace FileUtils
 		return genericPath;
 	}
 
+	// Per-user writable location for caches, from SDL's pref path; falls back to the working directory.
+	inline std::filesystem::path getUserDataPath(const std::filesystem::path& relativePath)
+	{
+		char* prefPathCStr = SDL_GetPrefPath("FractaVista", "FractaVista");
+		if (!prefPathCStr)
+		{
+			FRACTAL_WARN("SDL_GetPrefPath failed ({}); using the working directory.", SDL_GetError());
+			return relativePath;
+		}
+
+		std::filesystem::path prefPath(prefPathCStr);
+		SDL_free(prefPathCStr);
+		return (prefPath / relativePath).lexically_normal();
+	}
+
 	inline std::optional<std::string> readFile(const std::filesystem::path& path)
 	{
 		if (!std::filesystem::exists(path))
@@ -58,80 +73,4 @@ namespace FileUtils
 		return content;
 	}
 
-	namespace detail
-	{
-		inline void loadShaderSourceRecursive(const std::filesystem::path& path, std::stringstream& ss,
-											  std::set<std::string>& includedFiles, int depth = 0)
-		{
-			if (includedFiles.count(path.string()))
-			{
-				FRACTAL_TRACE("Skipping already included file: {}", path.string());
-				return;
-			}
-			FRACTAL_TRACE("Loading shader file: {}", path.string());
-
-			auto fileContent = readFile(path);
-			if (!fileContent)
-			{
-				FRACTAL_ERROR("Could not read shader file: {}", path.string());
-				return;
-			}
-
-			includedFiles.insert(path.string());
-
-			std::stringstream contentStream(*fileContent);
-			std::string line;
-			const std::regex includeRegex(R"(^\s*#include\s+\"([^\"]+)\")");
-
-			while (std::getline(contentStream, line))
-			{
-				std::smatch match;
-				if (std::regex_search(line, match, includeRegex) && match.size() > 1)
-				{
-					std::filesystem::path includePath = path.parent_path() / match[1].str();
-					FRACTAL_TRACE("Found include directive: {} -> {}", line, includePath.string());
-					loadShaderSourceRecursive(includePath, ss, includedFiles, depth + 1);
-				}
-				else
-				{
-					ss << line << '\n';
-				}
-			}
-
-			if (depth > 0)
-			{
-				FRACTAL_TRACE("Loaded shader: {}", path.filename().string());
-			}
-		}
-	} // namespace detail
-
-	inline std::optional<std::string> loadShaderSource(const std::filesystem::path& path)
-	{
-		FRACTAL_TRACE("Starting shader source load for {}", path.string());
-
-		std::stringstream ss;
-		std::set<std::string> includedFiles;
-		detail::loadShaderSourceRecursive(path, ss, includedFiles);
-
-		auto source = ss.str();
-		if (source.empty())
-		{
-			FRACTAL_TRACE("Shader source is empty after loading: {}", path.string());
-			return std::nullopt;
-		}
-
-		size_t numIncludes = includedFiles.size() > 0 ? includedFiles.size() - 1 : 0;
-
-		if (numIncludes > 0)
-		{
-			FRACTAL_TRACE("Loaded shader: {} + {} includes", path.filename().string(), numIncludes);
-		}
-		else
-		{
-			FRACTAL_TRACE("Loaded shader: {}", path.filename().string());
-		}
-
-		return source;
-	}
-
 } // namespace FileUtils
@@ -31,6 +31,39 @@ namespace glm
 	}
 }
 
+// Coordinates are stored as exact hex strings so deep-zoom presets reload bit for bit. Plain numbers and
+// decimal strings are accepted as well, which keeps older and hand-written presets loading.
+inline void to_json(json& j, const BigFixed& v)
+{
+	j = v.toHexString();
+}
+inline void from_json(const json& j, BigFixed& v)
+{
+	if (j.is_number())
+	{
+		const double value = j.get<double>();
+		if (!BigFixed::isRepresentable(value))
+			throw json::out_of_range::create(406, "coordinate out of range " + j.dump(), &j);
+		v = BigFixed(value, FractalState::DEFAULT_COORDINATE_LIMBS);
+		return;
+	}
+
+	auto parsed = BigFixed::fromString(j.get<std::string>());
+	if (!parsed)
+		throw json::type_error::create(302, "invalid coordinate string " + j.dump(), &j);
+	v = *parsed;
+}
+
+inline void to_json(json& j, const BigVec2& v)
+{
+	j = { v.x, v.y };
+}
+inline void from_json(const json& j, BigVec2& v)
+{
+	j.at(0).get_to(v.x);
+	j.at(1).get_to(v.y);
+}
+
 inline void to_json(json& j, const FractalSpecificParams& p)
 {
 	j = { { "juliaConstant", p.juliaConstant } };
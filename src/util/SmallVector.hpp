@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+// Contiguous buffer of trivially copyable values that keeps up to N elements inline and only touches the heap
+// beyond that. Intentionally minimal: it supports what fixed-size numeric code needs (sized construction,
+// assign, indexing and iteration), not a full std::vector interface.
+template <typename T, size_t N>
+class SmallVector
+{
+		static_assert(std::is_trivially_copyable_v<T>, "SmallVector copies elements with std::copy");
+
+	public:
+		SmallVector() = default;
+		SmallVector(size_t count, const T& value) { assign(count, value); }
+
+		SmallVector(const SmallVector& other) { assign(other.begin(), other.end()); }
+		SmallVector& operator=(const SmallVector& other)
+		{
+			if (this != &other)
+				assign(other.begin(), other.end());
+			return *this;
+		}
+
+		SmallVector(SmallVector&& other) noexcept { moveFrom(other); }
+		SmallVector& operator=(SmallVector&& other) noexcept
+		{
+			if (this != &other)
+				moveFrom(other);
+			return *this;
+		}
+
+		~SmallVector() = default;
+
+		void assign(size_t count, const T& value)
+		{
+			allocate(count);
+			std::fill_n(data(), count, value);
+		}
+
+		template <typename It>
+		void assign(It first, It last)
+		{
+			const auto count = static_cast<size_t>(std::distance(first, last));
+			if (m_heap == nullptr && count <= N)
+			{
+				// Copying first keeps self-overlapping ranges safe.
+				std::array<T, N> scratch{};
+				std::copy(first, last, scratch.begin());
+				m_inline = scratch;
+				m_size = count;
+				return;
+			}
+
+			auto buffer = std::make_unique_for_overwrite<T[]>(count);
+			std::copy(first, last, buffer.get());
+			m_heap = std::move(buffer);
+			m_capacity = count;
+			m_size = count;
+		}
+
+		[[nodiscard]] size_t size() const { return m_size; }
+		[[nodiscard]] bool empty() const { return m_size == 0; }
+
+		[[nodiscard]] T* data() { return m_heap ? m_heap.get() : m_inline.data(); }
+		[[nodiscard]] const T* data() const { return m_heap ? m_heap.get() : m_inline.data(); }
+
+		[[nodiscard]] T* begin() { return data(); }
+		[[nodiscard]] T* end() { return data() + m_size; }
+		[[nodiscard]] const T* begin() const { return data(); }
+		[[nodiscard]] const T* end() const { return data() + m_size; }
+
+		T& operator[](size_t index) { return data()[index]; }
+		const T& operator[](size_t index) const { return data()[index]; }
+
+	private:
+		// Makes room for `count` elements without preserving the current contents.
+		void allocate(size_t count)
+		{
+			if (count > N && count > m_capacity)
+			{
+				m_heap = std::make_unique_for_overwrite<T[]>(count);
+				m_capacity = count;
+			}
+			m_size = count;
+		}
+
+		void moveFrom(SmallVector& other)
+		{
+			m_inline = other.m_inline;
+			m_heap = std::move(other.m_heap);
+			m_size = other.m_size;
+			m_capacity = other.m_capacity;
+			other.m_size = 0;
+			other.m_capacity = N;
+		}
+
+		std::array<T, N> m_inline{};
+		std::unique_ptr<T[]> m_heap;
+		size_t m_size = 0;
+		size_t m_capacity = N;
+};
@@ -0,0 +1,107 @@
+#include <cmath>
+#include <cstdlib>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "Test.hpp"
+#include "util/BigFixed.hpp"
+#include "util/JsonUtils.hpp"
+
+namespace
+{
+	// Parses `text` and checks it lands within one ulp of the double the C library reads from it.
+	void checkParsesLikeDouble(const char* text)
+	{
+		const std::optional<BigFixed> parsed = BigFixed::fromString(text);
+		CHECK(parsed.has_value());
+		const double expected = std::strtod(text, nullptr);
+		const double ulp = std::nextafter(std::fabs(expected), INFINITY) - std::fabs(expected);
+		CHECK_NEAR(parsed->toDouble(), expected, ulp);
+	}
+}
+
+FRACTAVISTA_TEST(bigFixedParsesShortDecimalsToWithinAnUlp)
+{
+	for (const char* text : { "0.1", "-1.25e-3", "0.3", "-0.75", "2.718281828459045", "1e-9", "-0.000123456789",
+							  "123.456", "4294967295.5" })
+	{
+		checkParsesLikeDouble(text);
+	}
+}
+
+FRACTAVISTA_TEST(bigFixedParsesDecimalsWithAtLeastCoordinatePrecision)
+{
+	// "0.1" needs only one limb by its digit count, which would leave it 1.4e-10 off.
+	CHECK(BigFixed::fromString("0.1")->getFractionLimbs() >= 3);
+}
+
+FRACTAVISTA_TEST(bigFixedRejectsMalformedStrings)
+{
+	for (const char* text : { "", "-", "abc", "1.2.3", "1e", "0x", "0xG", "99999999999", "1e100001" })
+		CHECK(!BigFixed::fromString(text).has_value());
+}
+
+FRACTAVISTA_TEST(bigFixedHexRoundTripsExactly)
+{
+	const BigFixed value = *BigFixed::fromString("-0x1.23456789ABCDEF0123");
+	CHECK(value.toHexString() == "-0x1.23456789ABCDEF0123");
+	CHECK(*BigFixed::fromString(value.toHexString()) == value);
+	CHECK(BigFixed(-0.75, 2).toHexString() == "-0x0.C");
+	CHECK(BigFixed(-0.75, 2).toDecimalString() == "-0.75");
+}
+
+FRACTAVISTA_TEST(bigFixedArithmeticMatchesDoubles)
+{
+	const double a = -1.7490234375;
+	const double b = 0.0009765625;
+	const BigFixed x(a, 3);
+	const BigFixed y(b, 3);
+	CHECK((x + y).toDouble() == a + b);
+	CHECK((x - y).toDouble() == a - b);
+	CHECK((x * y).toDouble() == a * b);
+	CHECK((x * 3).toDouble() == a * 3);
+	CHECK(x.square().toDouble() == a * a);
+	CHECK((-x).toDouble() == -a);
+	CHECK(x < y);
+	CHECK((x - x).isZero());
+}
+
+FRACTAVISTA_TEST(bigFixedKeepsBitsBeyondDouble)
+{
+	// 2^-80 vanishes next to 1 in a double but survives in three fraction limbs.
+	const BigFixed one(1.0, 3);
+	const BigFixed tiny(std::ldexp(1.0, -80), 3);
+	CHECK((one + tiny) != one);
+	CHECK(((one + tiny) - one) == tiny);
+}
+
+FRACTAVISTA_TEST(bigFixedNarrowingRoundsToNearest)
+{
+	// 1 - 2^-40 is closer to 1 than to the one-limb value below it.
+	const BigFixed almostOne = BigFixed(1.0, 2) - BigFixed(std::ldexp(1.0, -40), 2);
+	CHECK(almostOne.withPrecision(1).toDouble() == 1.0);
+	CHECK((-almostOne).withPrecision(1).toDouble() == -1.0);
+	// Below half a unit of the last kept limb rounds down.
+	const BigFixed small = BigFixed(0.5, 2) + BigFixed(std::ldexp(1.0, -40), 2);
+	CHECK(small.withPrecision(1).toDouble() == 0.5);
+}
+
+FRACTAVISTA_TEST(bigFixedRangeChecksDoubles)
+{
+	CHECK(BigFixed::isRepresentable(4294967295.5));
+	CHECK(!BigFixed::isRepresentable(4294967296.0));
+	CHECK(!BigFixed::isRepresentable(NAN));
+	CHECK(!BigFixed::isRepresentable(-INFINITY));
+	CHECK_THROWS(BigFixed(1e300, 2), std::out_of_range);
+	CHECK_THROWS(BigFixed(NAN, 2), std::out_of_range);
+	CHECK(BigFixed::saturated(NAN, 2).isZero());
+	CHECK(BigFixed::saturated(-1e300, 2).toDouble() < -4294967295.0);
+}
+
+FRACTAVISTA_TEST(bigFixedLegacyPresetNumbersAreRangeChecked)
+{
+	CHECK(json(0.25).get<BigFixed>().toDouble() == 0.25);
+	CHECK_THROWS(json(1e10).get<BigFixed>(), json::out_of_range);
+	CHECK_THROWS(json("not a number").get<BigFixed>(), json::type_error);
+}
@@ -0,0 +1,107 @@
+#include <cmath>
+#include <vector>
+
+#include "Test.hpp"
+#include "fractal/Keyframes.hpp"
+
+namespace
+{
+	Keyframe makeKeyframe(double time, double x, double y, double zoom, int maxIterations)
+	{
+		FractalState state;
+		state.offset = { BigFixed(x, FractalState::DEFAULT_COORDINATE_LIMBS),
+						 BigFixed(y, FractalState::DEFAULT_COORDINATE_LIMBS) };
+		state.zoom = zoom;
+		state.maxIterations = maxIterations;
+		return { .time = time, .state = state };
+	}
+}
+
+FRACTAVISTA_TEST(keyframesCountFramesAtBothEnds)
+{
+	const std::vector<Keyframe> keyframes = { makeKeyframe(1.0, 0.0, 0.0, 1.0, 100),
+											  makeKeyframe(3.0, 0.0, 0.0, 1.0, 100) };
+	CHECK(Keyframes::getDuration(keyframes) == 2.0);
+	CHECK(Keyframes::getFrameCount(keyframes, 30) == 61);
+	CHECK(Keyframes::getFrameCount({}, 30) == 0);
+}
+
+FRACTAVISTA_TEST(keyframesZoomInLogSpaceAndClampToTheRange)
+{
+	const std::vector<Keyframe> keyframes = { makeKeyframe(0.0, -0.5, 0.0, 1.0, 100),
+											  makeKeyframe(2.0, -0.5, 0.0, 100.0, 300) };
+	FractalState state;
+	Keyframes::apply(keyframes, 1.0, state);
+	CHECK_NEAR(state.zoom, 10.0, 1e-12);
+	CHECK(state.maxIterations == 200);
+
+	Keyframes::apply(keyframes, -1.0, state);
+	CHECK(state.zoom == 1.0);
+	CHECK(state.maxIterations == 100);
+	Keyframes::apply(keyframes, 5.0, state);
+	CHECK(state.zoom == 100.0);
+	CHECK(state.offset == keyframes.back().state.offset);
+}
+
+FRACTAVISTA_TEST(keyframesKeepTheFixedPointOfTheZoomInPlace)
+{
+	// The similarity taking the first view to the second fixes p = (c1 * z1 - c0 * z0) / (z1 - z0); every
+	// intermediate view must show it at the same screen position, (p - c) * zoom.
+	const double c0 = -0.75;
+	const double z0 = 0.5;
+	const double c1 = -0.74;
+	const double z1 = 50.0;
+	const std::vector<Keyframe> keyframes = { makeKeyframe(0.0, c0, c0, z0, 100), makeKeyframe(1.0, c1, c1, z1, 100) };
+	const double fixedPoint = ((c1 * z1) - (c0 * z0)) / (z1 - z0);
+
+	FractalState state;
+	for (const double time : { 0.1, 0.37, 0.5, 0.9 })
+	{
+		Keyframes::apply(keyframes, time, state);
+		CHECK_NEAR((fixedPoint - state.offset.x.toDouble()) * state.zoom, (fixedPoint - c0) * z0, 1e-9);
+		CHECK_NEAR((fixedPoint - state.offset.y.toDouble()) * state.zoom, (fixedPoint - c0) * z0, 1e-9);
+	}
+}
+
+FRACTAVISTA_TEST(keyframesKeepDeepZoomCentersBelowPixelScale)
+{
+	const int limbs = BigFixed::limbsForResolution(1e40);
+	Keyframe from = makeKeyframe(0.0, -0.75, 0.0, 1.0, 100);
+	from.state.offset = from.state.offset.withPrecision(limbs);
+	Keyframe to = makeKeyframe(1.0, 0.0, 0.0, 1e40, 100);
+	to.state.offset.x = BigFixed::fromString("-0x0.BC8F2A71D06E93B5C4A7F1E2D3C4B5A69788").value().withPrecision(limbs);
+	to.state.offset.y = BigFixed::fromString("0x0.1A2B3C4D5E6F708192A3B4C5D6E7F8091A2B").value().withPrecision(limbs);
+
+	// Halfway in log space the view is at zoom 1e20, where a pixel is 1e-20 wide: the distance left to travel must
+	// be right to a small fraction of that, far beyond what a double center could hold.
+	FractalState state;
+	Keyframes::apply({ from, to }, 0.5, state);
+	CHECK_NEAR(state.zoom, 1e20, 1e8);
+	const double remaining
+		= ((1.0 / state.zoom) - (1.0 / to.state.zoom)) / ((1.0 / from.state.zoom) - (1.0 / to.state.zoom));
+	const double expectedX = (from.state.offset.x - to.state.offset.x).toDouble() * remaining;
+	const double expectedY = (from.state.offset.y - to.state.offset.y).toDouble() * remaining;
+	CHECK_NEAR((state.offset.x - to.state.offset.x).toDouble() * state.zoom, expectedX * state.zoom, 1e-3);
+	CHECK_NEAR((state.offset.y - to.state.offset.y).toDouble() * state.zoom, expectedY * state.zoom, 1e-3);
+}
+
+FRACTAVISTA_TEST(keyframesCrossfadePalettesWithDifferentStops)
+{
+	Keyframe from = makeKeyframe(0.0, 0.0, 0.0, 1.0, 100);
+	from.state.coloring.palette = { { .color = { 0.0F, 0.0F, 0.0F }, .position = 0.0F },
+									{ .color = { 1.0F, 1.0F, 1.0F }, .position = 1.0F } };
+	Keyframe to = makeKeyframe(1.0, 0.0, 0.0, 1.0, 100);
+	to.state.coloring.palette = { { .color = { 1.0F, 0.0F, 0.0F }, .position = 0.0F },
+								  { .color = { 0.0F, 1.0F, 0.0F }, .position = 0.5F },
+								  { .color = { 0.0F, 0.0F, 1.0F }, .position = 1.0F } };
+
+	FractalState state;
+	Keyframes::apply({ from, to }, 0.5, state);
+	const std::vector<ColorStop>& palette = state.coloring.palette;
+	CHECK(palette.size() == 3);
+	// Halfway between the grey 0.5 of the first gradient and the green of the second.
+	CHECK(palette[1].position == 0.5F);
+	CHECK_NEAR(palette[1].color.x, 0.25, 1e-6);
+	CHECK_NEAR(palette[1].color.y, 0.75, 1e-6);
+	CHECK_NEAR(palette[1].color.z, 0.25, 1e-6);
+}
@@ -0,0 +1,133 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Test.hpp"
+#include "gfx/ShaderPreprocessor.hpp"
+
+namespace
+{
+	// A scratch directory of shader files, removed again when the test ends.
+	class ShaderDirectory
+	{
+		public:
+			explicit ShaderDirectory(std::string_view name)
+				: m_path(std::filesystem::temp_directory_path() / "fractavista_tests" / name)
+			{
+				std::filesystem::remove_all(m_path);
+				std::filesystem::create_directories(m_path);
+			}
+
+			~ShaderDirectory() { std::filesystem::remove_all(m_path); }
+
+			ShaderDirectory(const ShaderDirectory&) = delete;
+			ShaderDirectory& operator=(const ShaderDirectory&) = delete;
+
+			std::filesystem::path write(const std::filesystem::path& name, std::string_view content) const
+			{
+				const std::filesystem::path path = (m_path / name).lexically_normal();
+				std::filesystem::create_directories(path.parent_path());
+				std::ofstream(path, std::ios::binary) << content;
+				return path;
+			}
+
+		private:
+			std::filesystem::path m_path;
+	};
+
+	std::vector<std::string> lines(const std::string& text)
+	{
+		std::vector<std::string> result;
+		size_t start = 0;
+		while (start < text.size())
+		{
+			const size_t end = text.find('\n', start);
+			result.push_back(text.substr(start, end - start));
+			start = end == std::string::npos ? text.size() : end + 1;
+		}
+		return result;
+	}
+}
+
+FRACTAVISTA_TEST(shaderPreprocessorMapsIncludedLinesBackToTheirFiles)
+{
+	const ShaderDirectory directory("line_mapping");
+	directory.write("lib/Common.glsl", "float common() { return 1.0; }\nfloat other() { return 2.0; }\n");
+	const auto root = directory.write("Main.glsl", "#version 460 core\n"
+												   "#include \"lib/Common.glsl\"\n"
+												   "void main() {}\n");
+
+	ShaderPreprocessor preprocessor;
+	const PreprocessedShader shader = preprocessor.process(root, { "FRACTAL_MANDELBROT", "SAMPLES_X 2" });
+
+	const std::vector<std::string> expected = {
+		"#version 460 core",
+		"#define FRACTAL_MANDELBROT",
+		"#define SAMPLES_X 2",
+		"#line 2 0",
+		"#line 1 1",
+		"float common() { return 1.0; }",
+		"float other() { return 2.0; }",
+		"#line 3 0",
+		"void main() {}",
+	};
+	CHECK(lines(shader.source) == expected);
+	CHECK(shader.files.size() == 2);
+	CHECK(shader.files[0] == root);
+	CHECK(shader.files[1] == root.parent_path() / "lib" / "Common.glsl");
+}
+
+FRACTAVISTA_TEST(shaderPreprocessorIncludesEachFileOnce)
+{
+	const ShaderDirectory directory("include_once");
+	directory.write("Math.glsl", "float square(float x) { return x * x; }\n");
+	directory.write("Orbit.glsl", "#include \"Math.glsl\"\nfloat orbit() { return square(2.0); }\n");
+	const auto root = directory.write("Main.glsl", "#version 460 core\n"
+												   "#include \"Math.glsl\"\n"
+												   "#include \"Orbit.glsl\"\n"
+												   "#include \"./Math.glsl\"\n"
+												   "void main() {}\n");
+
+	ShaderPreprocessor preprocessor;
+	const PreprocessedShader shader = preprocessor.process(root);
+
+	size_t definitions = 0;
+	for (size_t at = shader.source.find("float square"); at != std::string::npos;
+		 at = shader.source.find("float square", at + 1))
+		++definitions;
+	CHECK(definitions == 1);
+	CHECK(shader.files.size() == 3);
+	// A skipped include still takes up its line, so the root's following lines keep their numbers.
+	const std::vector<std::string> output = lines(shader.source);
+	CHECK(output.back() == "void main() {}");
+	CHECK(output[output.size() - 2].empty());
+	CHECK(output[output.size() - 3] == "#line 4 0");
+}
+
+FRACTAVISTA_TEST(shaderPreprocessorRereadsChangedFiles)
+{
+	const ShaderDirectory directory("reread");
+	const auto root = directory.write("Main.glsl", "#version 460 core\nvoid main() {}\n");
+
+	ShaderPreprocessor preprocessor;
+	CHECK(preprocessor.process(root).source.find("void main() {}") != std::string::npos);
+
+	directory.write("Main.glsl", "#version 460 core\nvoid main() { return; }\n");
+	std::filesystem::last_write_time(root, std::filesystem::last_write_time(root) + std::chrono::seconds(1));
+	CHECK(preprocessor.process(root).source.find("void main() { return; }") != std::string::npos);
+}
+
+FRACTAVISTA_TEST(shaderPreprocessorRejectsMissingFilesAndVersion)
+{
+	const ShaderDirectory directory("errors");
+	const auto noVersion = directory.write("NoVersion.glsl", "void main() {}\n");
+	const auto missingInclude = directory.write("Main.glsl", "#version 460 core\n#include \"Missing.glsl\"\n");
+
+	ShaderPreprocessor preprocessor;
+	CHECK_THROWS(preprocessor.process(noVersion), std::runtime_error);
+	CHECK_THROWS(preprocessor.process(missingInclude), std::runtime_error);
+}
@@ -0,0 +1,74 @@
+#include <cstdint>
+#include <vector>
+
+#include "Test.hpp"
+#include "core/TaskScheduler.hpp"
+#include "fractal/Supersampling.hpp"
+
+namespace
+{
+	constexpr ResolveFilter FILTERS[] = { ResolveFilter::Box, ResolveFilter::Mitchell, ResolveFilter::Lanczos };
+}
+
+FRACTAVISTA_TEST(supersamplingWeightsAreNormalized)
+{
+	for (const ResolveFilter filter : FILTERS)
+	{
+		for (int factor = 1; factor <= Supersampling::MAX_FACTOR; ++factor)
+		{
+			const std::vector<float> weights = Supersampling::getWeights(filter, factor);
+			CHECK(weights.size() == static_cast<size_t>(((2 * Supersampling::getMargin(filter)) + 1) * factor));
+			CHECK(weights.size() <= static_cast<size_t>(Supersampling::MAX_TAPS));
+
+			double sum = 0.0;
+			for (const float weight : weights)
+				sum += weight;
+			CHECK_NEAR(sum, 1.0, 1e-6);
+		}
+	}
+}
+
+FRACTAVISTA_TEST(supersamplingWeightsAreSymmetric)
+{
+	for (const ResolveFilter filter : FILTERS)
+	{
+		const std::vector<float> weights = Supersampling::getWeights(filter, 3);
+		for (size_t k = 0; k < weights.size(); ++k)
+			CHECK_NEAR(weights[k], weights[weights.size() - 1 - k], 1e-7);
+	}
+}
+
+FRACTAVISTA_TEST(supersamplingBoxFilterAveragesItsOwnPixel)
+{
+	CHECK(Supersampling::getMargin(ResolveFilter::Box) == 0);
+	for (const float weight : Supersampling::getWeights(ResolveFilter::Box, 4))
+		CHECK_NEAR(weight, 0.25, 1e-7);
+}
+
+FRACTAVISTA_TEST(supersamplingResolveKeepsFlatColors)
+{
+	TaskScheduler scheduler(2);
+	const int width = 5;
+	const int height = 3;
+	const int factor = 2;
+	for (const ResolveFilter filter : FILTERS)
+	{
+		// Mitchell and Lanczos have negative lobes, so only a flat image is guaranteed to come back unchanged.
+		const int margin = Supersampling::getMargin(filter);
+		const size_t sampleCount = static_cast<size_t>((width + (2 * margin)) * factor)
+								   * static_cast<size_t>((height + (2 * margin)) * factor);
+		std::vector<uint8_t> samples;
+		for (size_t i = 0; i < sampleCount; ++i)
+			samples.insert(samples.end(), { 12, 200, 77, 255 });
+
+		const std::vector<uint8_t> pixels = Supersampling::resolve(scheduler, samples, width, height, factor, filter);
+		CHECK(pixels.size() == static_cast<size_t>(width * height * 4));
+		for (size_t i = 0; i < pixels.size(); i += 4)
+		{
+			CHECK(pixels[i] == 12);
+			CHECK(pixels[i + 1] == 200);
+			CHECK(pixels[i + 2] == 77);
+			CHECK(pixels[i + 3] == 255);
+		}
+	}
+}
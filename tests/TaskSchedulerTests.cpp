@@ -0,0 +1,72 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Test.hpp"
+#include "core/TaskScheduler.hpp"
+
+FRACTAVISTA_TEST(parallelForRunsEveryIndexOnce)
+{
+	TaskScheduler scheduler(4);
+	std::vector<std::atomic<int>> hits(1000);
+	scheduler.parallelFor(static_cast<int>(hits.size()), [&](int index) { hits[static_cast<size_t>(index)]++; });
+	for (const auto& count : hits)
+		CHECK(count.load() == 1);
+}
+
+FRACTAVISTA_TEST(parallelForRethrowsTheFirstFailure)
+{
+	TaskScheduler scheduler(4);
+	std::atomic<int> ran{ 0 };
+	CHECK_THROWS(scheduler.parallelFor(10000,
+									   [&](int) {
+										   ++ran;
+										   throw std::runtime_error("boom");
+									   }),
+				 std::runtime_error);
+	// Every worker stops at its first item: the rest are skipped once one has thrown.
+	CHECK(ran.load() < 100);
+
+	// The scheduler stays usable afterwards.
+	std::atomic<int> sum{ 0 };
+	scheduler.parallelFor(100, [&](int index) { sum += index; });
+	CHECK(sum.load() == 4950);
+}
+
+FRACTAVISTA_TEST(outsideCallerOnlyRunsItsOwnItems)
+{
+	const std::thread::id caller = std::this_thread::get_id();
+	std::mutex mutex;
+	std::vector<std::thread::id> taskThreads;
+	{
+		TaskScheduler scheduler(4);
+		for (int i = 0; i < 16; ++i)
+		{
+			scheduler.submit([&] {
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+				const std::lock_guard lock(mutex);
+				taskThreads.push_back(std::this_thread::get_id());
+			});
+		}
+
+		std::atomic<int> items{ 0 };
+		scheduler.parallelFor(64, [&](int) { ++items; });
+		CHECK(items.load() == 64);
+	}
+
+	// The destructor drained the queue, so every task ran, and none of them on the waiting caller.
+	CHECK(taskThreads.size() == 16);
+	for (const std::thread::id id : taskThreads)
+		CHECK(id != caller);
+}
+
+FRACTAVISTA_TEST(nestedParallelForCompletes)
+{
+	TaskScheduler scheduler(4);
+	std::atomic<int> total{ 0 };
+	scheduler.parallelFor(8, [&](int) { scheduler.parallelFor(8, [&](int) { ++total; }); });
+	CHECK(total.load() == 64);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cmath>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// A minimal test harness for fractavista_core, so the tests need nothing beyond the library's own dependencies.
+// Every FRACTAVISTA_TEST registers itself; a failed check throws, which ends that test and lets the others run.
+namespace test
+{
+	struct Case
+	{
+			const char* name;
+			void (*run)();
+	};
+
+	struct Failure : std::runtime_error
+	{
+			using std::runtime_error::runtime_error;
+	};
+
+	inline std::vector<Case>& registry()
+	{
+		static std::vector<Case> cases;
+		return cases;
+	}
+
+	struct Registrar
+	{
+			Registrar(const char* name, void (*run)()) { registry().push_back({ .name = name, .run = run }); }
+	};
+
+	inline void fail(const char* file, int line, const std::string& message)
+	{
+		throw Failure(std::format("{}:{}: {}", file, line, message));
+	}
+}
+
+#define FRACTAVISTA_TEST(name)                                                                                         \
+	static void name();                                                                                                \
+	static const ::test::Registrar name##Registrar(#name, name);                                                       \
+	static void name()
+
+#define CHECK(condition)                                                                                               \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if (!(condition))                                                                                              \
+			::test::fail(__FILE__, __LINE__, "CHECK(" #condition ") failed");                                          \
+	} while (false)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                                                        \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		const double checkActual = (actual);                                                                           \
+		const double checkExpected = (expected);                                                                       \
+		if (!(std::fabs(checkActual - checkExpected) <= (tolerance)))                                                  \
+			::test::fail(__FILE__, __LINE__,                                                                           \
+						 std::format("{} is {:.17g}, expected {:.17g}", #actual, checkActual, checkExpected));         \
+	} while (false)
+
+#define CHECK_THROWS(expression, exceptionType)                                                                        \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		bool checkThrew = false;                                                                                       \
+		try                                                                                                            \
+		{                                                                                                              \
+			(void)(expression);                                                                                        \
+		}                                                                                                              \
+		catch (const exceptionType&)                                                                                   \
+		{                                                                                                              \
+			checkThrew = true;                                                                                         \
+		}                                                                                                              \
+		if (!checkThrew)                                                                                               \
+			::test::fail(__FILE__, __LINE__, #expression " did not throw " #exceptionType);                            \
+	} while (false)
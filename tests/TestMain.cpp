@@ -0,0 +1,39 @@
+#include <cstdio>
+#include <exception>
+#include <string_view>
+
+#include "Test.hpp"
+#include "util/Logger.hpp"
+
+// Runs every registered test, or only those whose name contains the first argument.
+int main(int argc, char** argv)
+{
+	Log::Init();
+	Log::SetLevel(spdlog::level::warn);
+
+	const std::string_view filter = argc > 1 ? argv[1] : "";
+	int run = 0;
+	int failed = 0;
+	for (const test::Case& testCase : test::registry())
+	{
+		if (std::string_view(testCase.name).find(filter) == std::string_view::npos)
+			continue;
+
+		++run;
+		try
+		{
+			testCase.run();
+			std::printf("[ passed ] %s\n", testCase.name);
+		}
+		catch (const std::exception& e)
+		{
+			++failed;
+			std::printf("[ FAILED ] %s\n           %s\n", testCase.name, e.what());
+		}
+	}
+	std::printf("%d of %d tests passed.\n", run - failed, run);
+
+	Log::Shutdown();
+
+	return failed == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+#include <vector>
+
+#include "Test.hpp"
+#include "fractal/TileQueue.hpp"
+
+FRACTAVISTA_TEST(tileQueueOrdersMostExpensiveFirst)
+{
+	const std::vector<float> costs = { 10.0F, 0.0F, 500.0F, 20.0F, 0.0F, 500.0F };
+	const std::vector<GLuint> expected = { 2, 5, 3, 0, 1, 4 };
+	CHECK(TileQueue::orderByCost(costs) == expected);
+}
+
+FRACTAVISTA_TEST(tileQueueKeepsUnmeasuredTilesInRowOrder)
+{
+	const std::vector<float> costs(5, 0.0F);
+	const std::vector<GLuint> expected = { 0, 1, 2, 3, 4 };
+	CHECK(TileQueue::orderByCost(costs) == expected);
+	CHECK(TileQueue::orderByCost({}).empty());
+}